@@ -1,778 +1,6154 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
+// clock_gettime (benchmark timer) and realpath (distributed sweeps) are hidden
+// by a strict -std=c99 build
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 700
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include <math.h>
+#include <stdint.h>
+
+// Vector units for the aging scoring kernel (aging_scan_select); without
+// -mavx2 (or /arch:AVX2) on x86 it falls back to plain C
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Engine skeletons (see SchedulePolicy) are forced inline into each engine, so
+// the policy they are handed is a constant there and its calls go direct
+#if defined(__GNUC__)
+#define ENGINE_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define ENGINE_INLINE static __forceinline
+#else
+#define ENGINE_INLINE static inline
+#endif
 
 // ============================================
 // CONSTANTS
 // ============================================
-#define MAX_PROCESSES 100
 #define MAX_LINE_LENGTH 256
+#define INITIAL_TABLE_CAPACITY 64 // Starting size when the input size is unknown
+#define READ_BLOCK_SIZE (1 << 20)   // Bytes read per fread() when loading process files
+#define MAX_REPORTED_BAD_LINES 10   // Malformed lines reported individually per file
+
+// Binary process trace (see write_processes_binary): little-endian, fixed-width records
+#define BINARY_TRACE_MAGIC "CPUTRACE"
+#define BINARY_TRACE_VERSION 2 // 64-bit times; version 1 (32-bit) traces are still read
+#define BINARY_FIELD_PID 0x1u
+#define BINARY_FIELD_ARRIVAL 0x2u
+#define BINARY_FIELD_BURST 0x4u
+#define BINARY_FIELD_PRIORITY 0x8u // Clear if the source CSV had no priority column
+#define BINARY_FIELDS_REQUIRED (BINARY_FIELD_PID | BINARY_FIELD_ARRIVAL | BINARY_FIELD_BURST)
+#define BINARY_RECORDS_PER_BLOCK 65536
+
+// Algorithm ids (same numbers as the menu entries)
+#define ALG_ROUND_ROBIN 1
+#define ALG_AGING 2
+#define ALG_SJF 3
+#define ALG_SRTF 4
+#define ALG_PRIORITY 5
+#define ALG_MLFQ 6
+#define ALG_COUNT 6
+
+// Multilevel feedback queue (mlfq_engine)
+#define MLFQ_MAX_LEVELS 32       // One bit per level in the non-empty bitmap
+#define MLFQ_DEFAULT_LEVELS 3    // Quanta 2, 4, 8 (each level doubles the one above)
+#define MLFQ_DEFAULT_QUANTUM 2   // Quantum of the top level
+#define MLFQ_DEFAULT_BOOST 50    // Time between priority boosts (0 = never)
+
+#define MAX_SWEEP_THREADS 256
+
+// Distributed sweeps (see DISTRIBUTED SWEEPS): files in the shared work directory
+#define SWEEP_PLAN_FILE "plan.txt"
+#define SWEEP_PLAN_MAGIC "CPUSWEEP"
+#define SWEEP_PLAN_VERSION 3
+#define SWEEP_RESULT_MAGIC "CPUSWRES"
+#define SWEEP_BYTE_ORDER 0x01020304u // Byte-order mark of result files (reads back swapped on the other byte order)
+#define SWEEP_DEFAULT_BATCH 64  // Configurations per batch without --batch
+#define SWEEP_POLL_SECONDS 1    // Coordinator's pause between looks at unfinished batches
+#define SWEEP_PLAN_WAIT 60      // Seconds a worker waits for the coordinator's plan to appear
+#define SWEEP_CLAIM_TIMEOUT 1800 // Seconds a claim may go unpublished before the coordinator runs the batch again
+#define SWEEP_PATH_MAX 1024
+#define SCRATCH_BLOCK_SIZE (1 << 16) // Smallest block a ScratchArena allocates
+
+// Multi-CPU simulation (multicore_engine)
+#define MAX_CORES 256
+#define QUEUE_GLOBAL 0   // One ready set shared by every CPU
+#define QUEUE_PER_CORE 1 // One ready set per CPU, idle CPUs steal from the fullest
+                         // (Round Robin, aging and SJF; the others are single-CPU)
+
+// Aging weight search (search_aging_weights)
+#define SEARCH_MIN_WAITING 0
+#define SEARCH_MIN_TURNAROUND 1
+#define WEIGHT_SEARCH_POINTS 5  // Grid points per weight in each round
+#define WEIGHT_SEARCH_ROUNDS 4  // Each round halves the grid spacing around the best point
+
+// Latency metrics (see ScheduleMetrics)
+#define SLOWDOWN_BOUND 10        // Bounded slowdown: bursts shorter than this count as this long
+#define LATENCY_EXACT_LIMIT 32   // Histogram values below this get a bucket each
+#define LATENCY_SUB_BUCKETS 16   // Histogram buckets per power of two above that (error < 1/16)
+#define LATENCY_BUCKETS (LATENCY_EXACT_LIMIT + 58 * LATENCY_SUB_BUCKETS) // Covers every non-negative SimTime
+
+// Machine-readable results (see ResultsWriter)
+#define RESULTS_CSV 0          // One CSV line per record, first column = record type
+#define RESULTS_JSON 1         // One JSON object per line (JSON Lines)
+#define RESULTS_BUFFER_SIZE (1 << 16) // Bytes collected before each fwrite()
+
+// Synthetic workloads (see WorkloadConfig); the defaults offer a load of about 0.85
+#define WORKLOAD_ARRIVAL_RATE 0.4   // Mean arrivals per time unit between idle gaps (Poisson)
+#define WORKLOAD_BURST_SHAPE 1.5    // Pareto shape of burst times (mean about 2.6 once cut and truncated)
+#define WORKLOAD_BURST_MIN 1
+#define WORKLOAD_BURST_MAX 1000
+#define WORKLOAD_IDLE_CHANCE 0.002  // Chance that an arrival comes after an idle gap
+#define WORKLOAD_IDLE_GAP_MAX 500
+#define WORKLOAD_PRIORITIES 5
+
+// 64-bit FNV-1a (process_table_digest and golden runs)
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+// Golden runs (see GOLDEN RUNS)
+#define GOLDEN_MAGIC "CPUGOLDEN"
+#define GOLDEN_VERSION 2
+#define GOLDEN_CHUNK 4096             // Records per digest: a changed schedule is located to one chunk
+#define GOLDEN_TIME_SLACK 3.0         // Recorded time budget = slower of two runs * slack + GOLDEN_TIME_FLOOR
+#define GOLDEN_TIME_FLOOR 0.25        // Seconds, so tiny cases don't fail on scheduler noise
+#define GOLDEN_MEMORY_SLACK 1.5       // Recorded memory budget = engine scratch memory of the case * slack
+
+// Gantt chart rendering (see display_gantt_chart and write_gantt_svg)
+#define GANTT_EXACT_WIDTH 4096  // Widest text chart drawn at two characters per time unit
+#define GANTT_CHART_COLUMNS 120 // Width of the to-scale text chart drawn for longer timelines
+#define GANTT_SVG_COLUMNS 1200  // SVG time axis in pixels (one time bucket each)
+#define GANTT_SVG_LANE_HEIGHT 28
+
+// Incremental re-simulation (see EngineSnapshot)
+#define SNAPSHOT_DEFAULT_INTERVAL 1000 // Simulated time between snapshots
+
+// How aging_engine picks the next job (SweepConfig.aging_selection, --aging-select).
+// Multi-CPU aging always uses the heap.
+#define AGING_SELECT_HEAP 0 // Ready heap over a time-independent key, O(log n) per pick
+#define AGING_SELECT_SCAN 1 // Score every ready job at each pick (vectorized), the original selection rule
+#define AGING_SCORE_EPSILON 0.001 // Scan selection: scores this close tie, and the earlier arrival wins
+
+// Gantt block pids below 1 (idle blocks are pid -1)
+#define GANTT_SWITCH -2 // Context switch overhead (see charge_context_switch)
+#define GANTT_MIXED -3  // To-scale charts only: time shared by several processes (see gantt_scale)
+
+// ============================================
+// TRACE LEVELS
+// ============================================
+// Scheduler progress output is filtered twice: levels above TRACE_MAX_LEVEL are
+// compiled out (build with -DTRACE_MAX_LEVEL=TRACE_NONE for benchmark binaries),
+// and levels above trace_level are skipped at runtime.
+#define TRACE_NONE 0     // No scheduler output
+#define TRACE_SUMMARY 1  // Algorithm banners, settings and end-of-run summaries
+#define TRACE_DISPATCH 2 // One line per dispatch, idle gap and completion
+
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL TRACE_DISPATCH
+#endif
+
+int trace_level = TRACE_DISPATCH; // Runtime trace level (set from --trace)
+
+#define TRACE_ENABLED(level) ((level) <= TRACE_MAX_LEVEL && (level) <= trace_level)
+#define TRACE(level, ...)              \
+    do                                 \
+    {                                  \
+        if (TRACE_ENABLED(level))      \
+            printf(__VA_ARGS__);       \
+    } while (0)
+
+// ============================================
+// INSTRUMENTATION
+// ============================================
+// Hot-path counters and phase timers, collected while engine_stats points at
+// an EngineStats (set from --stats; single-threaded runs only, so sweeps leave
+// it NULL). Build with -DENGINE_STATS=0 to compile every STAT_* out.
+#ifndef ENGINE_STATS
+#define ENGINE_STATS 1
+#endif
+
+// Wall-clock phases of a run (EngineStats.seconds)
+#define PHASE_LOAD 0     // Reading the input file
+#define PHASE_SORT 1     // Sorting it by arrival
+#define PHASE_SCHEDULE 2 // The engine itself
+#define PHASE_METRICS 3  // Latency metrics over the results
+#define PHASE_RENDER 4   // Chart, tables or records
+#define PHASE_COUNT 5
+
+typedef struct
+{
+    long long dispatches;   // Jobs put on a CPU (every slice, not just the first)
+    long long queue_ops;    // Ready-set pushes and pops (queues, heaps, scan set)
+    long long selections;   // Picks of the next job from a ready set
+    long long candidates;   // Jobs compared or scored across those picks
+    long long idle_jumps;   // Idle blocks: the clock skipped to the next arrival
+    long long gantt_merges; // Slices folded into the previous Gantt block
+    double seconds[PHASE_COUNT];
+} EngineStats;
+
+EngineStats *engine_stats = NULL;
+
+#if ENGINE_STATS
+#define STAT_ADD(field, amount)              \
+    do                                       \
+    {                                        \
+        if (engine_stats != NULL)            \
+            engine_stats->field += (amount); \
+    } while (0)
+#define STAT_CLOCK() (engine_stats != NULL ? benchmark_clock() : 0.0)
+#define STAT_PHASE(phase, since)                                         \
+    do                                                                   \
+    {                                                                    \
+        if (engine_stats != NULL)                                        \
+            engine_stats->seconds[phase] += benchmark_clock() - (since); \
+    } while (0)
+#else
+#define STAT_ADD(field, amount) ((void)0)
+#define STAT_CLOCK() 0.0
+#define STAT_PHASE(phase, since) ((void)(since))
+#endif
 
 // ============================================
 // DATA STRUCTURES
 // ============================================
+// Simulated time and durations. 64-bit: traces recorded in microseconds span
+// days, well past what an int can hold.
+typedef long long SimTime;
+
 typedef struct
 {
-    int pid;             // Process ID
-    int arrival_time;    // Time when process arrives
-    int burst_time;      // Total CPU time needed
-    int priority;        // Priority (lower number = higher priority, optional)
-    int remaining_time;  // Time remaining (used for preemptive algorithms)
-    int completion_time; // Time when process finishes
-    int turnaround_time; // Completion time - Arrival time
-    int waiting_time;    // Turnaround time - Burst time
-    int started;         // Flag: has the process started? (0 = no, 1 = yes)
-    int completed;       // Flag: is the process done? (0 = no, 1 = yes)
+    int pid;                 // Process ID
+    int priority;            // Priority (lower number = higher priority, optional)
+    SimTime arrival_time;    // Time when process arrives
+    SimTime burst_time;      // Total CPU time needed
+    SimTime remaining_time;  // Time remaining (used for preemptive algorithms)
+    SimTime completion_time; // Time when process finishes
+    SimTime turnaround_time; // Completion time - Arrival time
+    SimTime waiting_time;    // Turnaround time - Burst time
+    SimTime first_run_time;  // Time of the first dispatch (valid once started; response time = this - arrival)
+    int started;             // Flag: has the process started? (0 = no, 1 = yes)
+    int completed;           // Flag: is the process done? (0 = no, 1 = yes)
 } Process;
 
+// Growable process store (sized from the input file, shared by every algorithm)
+typedef struct
+{
+    Process *items; // Heap-allocated process array
+    int count;      // Number of processes currently stored
+    int capacity;   // Number of slots allocated in items
+} ProcessTable;
+
 // Structure to track Gantt chart entries (including idle times)
 typedef struct
 {
-    int pid;        // Process ID (-1 for idle)
-    int start_time; // Start time of this block
-    int end_time;   // End time of this block
+    int pid;            // Process ID (-1 for idle)
+    int core;           // CPU that ran the block (always 0 on single-CPU runs)
+    SimTime start_time; // Start time of this block
+    SimTime end_time;   // End time of this block
 } GanttBlock;
 
+// Destination for Gantt blocks. Every backend keeps the running totals that
+// CPU utilization is computed from; write() (NULL = totals only) decides what
+// else happens to each block.
+typedef struct GanttSink GanttSink;
+struct GanttSink
+{
+    void (*write)(GanttSink *sink, const GanttBlock *block);
+    void *context; // Backend state (GanttBuffer, FILE, ...)
+
+    int blocks;          // Blocks emitted
+    SimTime first_start; // Earliest start_time seen
+    SimTime last_end;    // Latest end_time seen
+    SimTime idle_time;   // Total length of idle (pid -1) blocks
+    SimTime busy_time;   // Total length of process blocks
+    SimTime switch_time; // Total length of context switch (GANTT_SWITCH) blocks
+    int switches;        // Dispatches of a different process than the CPU ran last, charged or not
+
+    // Time a CPU spends switching to a different process than the one it ran
+    // last, charged by every engine that reports here (charge_context_switch).
+    // The first dispatch on a CPU is free. 0 (the default) = dispatches cost nothing.
+    int switch_cost;
+    GanttSink *lanes; // Per-CPU sinks (gantt_sink_init_lanes), NULL otherwise
+};
+
+// Growable in-memory Gantt chart (backend for display_gantt_chart)
+typedef struct
+{
+    GanttBlock *blocks;
+    int size;
+    int capacity;
+} GanttBuffer;
+
+// Engine state at a quiescent point of a run: a process has just completed,
+// no other job is resident and the first `taken` processes are all done. Everything the run does
+// after this depends only on these fields and processes[taken..], so a run
+// over a table that agrees up to there can start here (see resimulate).
+typedef struct
+{
+    SimTime time;       // Simulated time of the snapshot
+    int taken;          // Processes consumed from the source (all completed)
+    int last_pid;       // Process the CPU ran last (for context switch cost)
+    SimTime next_boost; // Next MLFQ priority boost (0 for the other engines)
+    GanttBlock open;    // Timeline block not yet reported (merging engines)
+    int has_open;
+    GanttSink totals;   // Sink counters at this point (write and context unused)
+} EngineSnapshot;
+
+// Snapshots taken during one run, oldest first, at most one per interval
+typedef struct
+{
+    EngineSnapshot *items;
+    int count;
+    int capacity;
+    SimTime interval; // Simulated time between snapshots
+    SimTime next_due; // No snapshot before this time
+} SnapshotLog;
+
+// Mean and tail of one latency distribution
+typedef struct
+{
+    double mean;
+    SimTime p50;
+    SimTime p95;
+    SimTime p99;
+    SimTime max;
+} LatencyStats;
+
+// What a finished run is judged by. Percentiles are nearest-rank: exact when
+// computed from the process table, within 1/16 when taken from a
+// MetricsAccumulator.
+typedef struct
+{
+    int processes;
+    LatencyStats waiting;    // Turnaround - burst
+    LatencyStats turnaround; // Completion - arrival
+    LatencyStats response;   // First dispatch - arrival
+    double avg_slowdown;     // Bounded slowdown: max(1, turnaround / max(burst, SLOWDOWN_BOUND))
+    double max_slowdown;
+} ScheduleMetrics;
+
+// Log-linear histogram: exact below LATENCY_EXACT_LIMIT, then
+// LATENCY_SUB_BUCKETS buckets per power of two. Constant size however many
+// samples it holds.
+typedef struct
+{
+    long long counts[LATENCY_BUCKETS];
+    long long samples;
+    long long total; // Exact sum (for the mean)
+    SimTime max;
+} LatencyHistogram;
+
+// ScheduleMetrics built one completion at a time (streaming and sweep runs,
+// where no process table is kept)
+typedef struct
+{
+    LatencyHistogram waiting;
+    LatencyHistogram turnaround;
+    LatencyHistogram response;
+    double slowdown_total;
+    double slowdown_max;
+} MetricsAccumulator;
+
+// Buffered writer for run, gantt, process and summary records (CSV or JSON
+// Lines). Records are formatted into the buffer and written out in large
+// fwrite() calls, so no text table is ever rendered.
+typedef struct
+{
+    FILE *out;
+    int format;   // RESULTS_CSV or RESULTS_JSON
+    char *buffer; // RESULTS_BUFFER_SIZE bytes
+    size_t used;
+    int run;      // Id of the current run (records carry it so runs can be told apart)
+} ResultsWriter;
+
+// Block-buffered CSV reader for process files (one record per line)
+typedef struct
+{
+    FILE *file;
+    const char *filename; // For diagnostics
+    char *buffer;         // Holds the current block plus any partial line carried over
+    size_t buffer_size;   // Allocated bytes in buffer
+    size_t length;        // Valid bytes in buffer
+    size_t pos;           // Start of the next unparsed line
+    long line_number;     // Line number of the last line handed to the parser
+    int at_eof;           // Set once fread() has returned everything
+    int bad_lines;        // Malformed lines skipped so far
+    int last_fields;      // Fields present on the last record returned (3 or 4)
+} ProcessReader;
+
+// Binary trace file header, followed by `count` BinaryProcessRecord entries
+// (BinaryProcessRecordV1 in version 1 traces)
+typedef struct
+{
+    char magic[8];        // BINARY_TRACE_MAGIC (not NUL-terminated)
+    uint32_t version;     // BINARY_TRACE_VERSION
+    uint32_t field_mask;  // BINARY_FIELD_* bits describing which record fields are meaningful
+    uint64_t count;       // Number of records
+    uint32_t record_size; // sizeof(BinaryProcessRecord), checked on load
+    uint32_t reserved;    // Zero
+} BinaryTraceHeader;
+
+typedef struct
+{
+    int32_t pid;
+    int32_t priority; // 0 when BINARY_FIELD_PRIORITY is clear
+    int64_t arrival_time;
+    int64_t burst_time;
+} BinaryProcessRecord;
+
+// Record layout of version 1 traces (32-bit times), still readable
+typedef struct
+{
+    int32_t pid;
+    int32_t arrival_time;
+    int32_t burst_time;
+    int32_t priority;
+} BinaryProcessRecordV1;
+
+// Read-only view of a whole file (see map_file). Every process that maps the
+// same trace shares one copy of it in the page cache.
+typedef struct
+{
+    const unsigned char *data; // NULL for an empty file
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+// Pull-based arrival feed for the scheduling engines. read() produces records in
+// non-decreasing arrival order; the source keeps one record of lookahead so an
+// engine can see the next arrival time without consuming it.
+typedef int (*ProcessSourceRead)(void *context, Process *out); // 1 = record produced, 0 = end
+
+typedef struct
+{
+    ProcessSourceRead read;
+    void *context;
+    Process next;     // Lookahead record (valid when has_next)
+    int has_next;     // 0 once the feed is exhausted
+    int taken;        // Records handed to the engine so far (sequence number of `next`)
+    int out_of_order; // Records whose arrival had to be clamped to keep time monotonic
+    const EngineSnapshot *resume; // Engine starts from here instead of the first arrival (NULL = from scratch)
+} ProcessSource;
+
+// Feed over an in-memory array (must already be sorted by arrival)
+typedef struct
+{
+    const Process *items;
+    int count;
+    int pos;
+} ArraySourceContext;
+
+// A process the engine is holding: admitted, not yet completed
+typedef struct
+{
+    Process process; // Working copy (remaining_time, started, completion_time, ...)
+    int seq;         // Position in arrival order; breaks ties and locates the original
+    int level;       // Feedback queue level (MLFQ only)
+} Job;
+
+// Ready-heap ordering key of a resident job. Keys live in their own packed
+// array beside the jobs, so a heap sift reads 16 bytes per comparison
+// instead of two whole Jobs.
+typedef struct
+{
+    double rank; // Lower runs first (see JobRank)
+    int seq;     // Equal ranks: input order, which is also arrival order
+} JobKey;
+
+// Computes a job's rank from its process; called whenever the job enters a ready heap
+typedef double (*JobRank)(const void *context, const Process *process);
+
+// Slot allocator for resident jobs; memory follows the number of jobs held at
+// once, not the length of the trace. Slot numbers stay valid as the pool grows.
+typedef struct
+{
+    Job *jobs;       // capacity slots
+    JobKey *keys;    // capacity slots, filled by job_pool_rank (NULL rank = never)
+    JobRank rank;
+    const void *rank_context;
+    int *free_slots; // Stack of unused slot numbers
+    int free_count;  // Entries in free_slots
+    int capacity;    // Allocated slots
+    int live;        // Slots in use
+    int peak;        // Highest value live has reached
+} JobPool;
+
+// Where an engine reports what happens, as it happens
+typedef struct
+{
+    GanttSink *gantt;                                                     // Finished Gantt blocks
+    void (*on_complete)(void *context, const Process *process, int seq); // A process completed
+    void *context;                                                        // Passed to on_complete
+    SnapshotLog *snapshots;                                               // Record snapshots here (NULL = don't)
+} ScheduleListener;
+
+// Builds Gantt blocks for a listener. With merging on (Round Robin merges
+// contiguous slices of the same PID) the last block is held back until it can
+// no longer grow, so it may be reported after the completion it ends with.
+typedef struct
+{
+    const ScheduleListener *listener;
+    GanttBlock open; // Block not yet reported
+    int has_open;
+    int merge;       // Extend the open block when the next one continues it
+    int core;        // Stamped on every block (0 unless set after init)
+} GanttTimeline;
+
+// Weights of the Modified FCFS with Aging score (see aging_engine)
+typedef struct
+{
+    double aging;    // How much waiting time matters
+    double burst;    // How much job length matters
+    double priority; // How much original priority matters
+} AgingWeights;
+
+// Levels of the multilevel feedback queue, top (0) to bottom
+typedef struct
+{
+    int levels;                   // 1..MLFQ_MAX_LEVELS
+    int quanta[MLFQ_MAX_LEVELS];  // Time quantum of each level
+    int boost_interval;           // Every this many time units all jobs return to level 0 (0 = never)
+} MlfqConfig;
+
+// Machine and algorithm for multicore_engine
+typedef struct
+{
+    int algorithm;        // ALG_*
+    int quantum;          // Round Robin time quantum
+    AgingWeights weights; // Aging score weights
+    int cores;            // Number of identical CPUs (1..MAX_CORES)
+    int queues;           // QUEUE_GLOBAL or QUEUE_PER_CORE
+} MulticoreConfig;
+
+// One experiment in a parameter sweep
+typedef struct
+{
+    int algorithm;        // ALG_*
+    int quantum;          // Round Robin time quantum (ignored by the other algorithms)
+    AgingWeights weights; // Aging score weights (ignored by the other algorithms)
+    MlfqConfig mlfq;      // Feedback queue levels (ignored by the other algorithms)
+    int switch_cost;      // GanttSink.switch_cost for the run
+    int aging_selection;  // AGING_SELECT_* (ignored by the other algorithms)
+} SweepConfig;
+
+// Schedule metrics for one SweepConfig
+typedef struct
+{
+    int processes;          // Processes that completed
+    float avg_waiting;      // Same definition as ScheduleMetrics
+    float avg_turnaround;   // Same definition as ScheduleMetrics
+    float avg_response;     // First dispatch - arrival
+    SimTime p99_turnaround; // Within 1/16 (MetricsAccumulator)
+    float cpu_utilization;  // Percent, same definition as calculate_and_display_cpu_utilization
+    int switches;           // Dispatches of a different process (GanttSink.switches), charged or not
+    float switch_overhead;  // Percent of the run spent switching
+    int peak_jobs;          // Most jobs the engine held at once
+} SweepResult;
+
+// A sweep shared out through a work directory (see DISTRIBUTED SWEEPS)
+typedef struct
+{
+    char trace[SWEEP_PATH_MAX]; // Process file every worker loads (the same absolute path on every node)
+    int processes;              // Processes in the trace (each worker checks its copy)
+    uint64_t digest;            // process_table_digest of the sorted trace (each worker checks its copy)
+    int config_count;           // Configurations in the plan
+    int batch_size;             // Configurations per batch (the last one may be shorter)
+    SweepConfig *configs;       // config_count entries
+} SweepPlan;
+
+// Header of a batch result file, followed by `count` SweepResultRecord entries
+typedef struct
+{
+    char magic[8];        // SWEEP_RESULT_MAGIC (not NUL-terminated)
+    uint32_t record_size; // sizeof(SweepResultRecord), checked on load
+    uint32_t byte_order;  // SWEEP_BYTE_ORDER as the writer stores it, checked on load
+    int32_t batch;
+    int32_t first;        // Plan index of the first record
+    int32_t count;
+} SweepResultHeader;
+
+// SweepResult as a worker publishes it: fixed width, in the writer's byte order
+// (readers on the other byte order refuse it, see SweepResultHeader.byte_order)
+typedef struct
+{
+    int64_t p99_turnaround;
+    int32_t processes;
+    int32_t switches;
+    int32_t peak_jobs;
+    float avg_waiting;
+    float avg_turnaround;
+    float avg_response;
+    float cpu_utilization;
+    float switch_overhead;
+} SweepResultRecord;
+
+// Shape of a generate_workload trace: Poisson arrivals, Pareto (heavy-tailed)
+// bursts, and now and then an idle gap so arrivals come in bursts
+typedef struct
+{
+    int count;           // Processes to generate (PIDs 1..count)
+    double arrival_rate; // Mean arrivals per time unit outside idle gaps
+    double burst_shape;  // Pareto shape, > 1 (smaller = heavier tail)
+    int burst_min;       // Pareto scale: shortest burst
+    int burst_max;       // Longer bursts are cut to this
+    double idle_chance;  // Chance that an arrival follows an idle gap
+    int idle_gap_max;    // Idle gaps are uniform in 1..idle_gap_max
+    int priorities;      // Priorities are uniform in 1..priorities
+    uint64_t seed;       // Same seed = same trace on every platform
+} WorkloadConfig;
+
+// A finished single-CPU run kept so that an edited copy of its table can be
+// re-simulated from a snapshot (see resimulate). gantt writes into chart, so
+// a RecordedRun must stay where recorded_run_init put it.
+typedef struct
+{
+    SweepConfig config;    // What was run
+    ProcessTable processes; // Input, arrival-sorted, with the results filled in
+    GanttBuffer chart;     // Every Gantt block
+    GanttSink gantt;       // Totals of chart
+    SnapshotLog snapshots;
+    int resumed_from;      // Snapshot of the base run this run started from (-1 = time 0)
+    int reused;            // Leading processes whose results came from the base run
+} RecordedRun;
+
+// A stream of records folded into one FNV-1a digest per GOLDEN_CHUNK records
+typedef struct
+{
+    uint64_t *chunks;  // chunk_count digests, the last one possibly still open
+    SimTime *times;    // Time of the first record of each chunk (not kept in golden files)
+    int chunk_count;
+    int capacity;
+    long long records; // Records folded in so far
+    int failed;        // An allocation failed; the digest is incomplete
+} GoldenDigest;
+
+// Fingerprint of one run (see golden_run)
+typedef struct
+{
+    GoldenDigest blocks;      // (pid, core, start, end) of every Gantt block, in emission order
+    GoldenDigest completions; // (pid, input order, first run, completion), in completion order
+    double seconds;           // Wall-clock time of the engine run
+    long engine_kb;           // Scratch memory the engine allocated for this run (scratch_arena_used), in KiB
+} GoldenRun;
+
+// One case of a golden file
+typedef struct
+{
+    char source[SWEEP_PATH_MAX]; // Trace file as given (relative to where the check runs), "" = generated
+    int generate;                // Generated trace: this many processes (default_workload_config)
+    uint64_t seed;               // Generated trace: its seed
+    SweepConfig config;          // What to run (switch cost and aging selection included)
+    double budget_seconds;       // Fail if the run takes longer
+    long budget_kb;              // Fail if the run's engine_kb is higher
+    GoldenRun run;               // The known-good schedule (only the digests are stored)
+} GoldenCase;
+
+// Circular FIFO of process indices (ready queue for Round Robin)
+typedef struct
+{
+    int *slots;   // Process indices, capacity entries
+    int capacity; // Maximum number of queued processes
+    int head;     // Index of the next process to dequeue
+    int size;     // Number of processes currently queued
+} RingQueue;
+
+// Binary min-heap of process indices ordered by a caller-supplied rule
+// before(context, a, b) returns nonzero if index a must be served before index b
+typedef int (*HeapBefore)(const void *context, int a, int b);
+
+typedef struct
+{
+    int *items;          // Heap-ordered process indices
+    int capacity;        // Maximum number of indices
+    int size;            // Number of indices currently stored
+    HeapBefore before;   // Ordering rule
+    const void *context; // Passed to before() (usually the process array)
+} IndexHeap;
+
+// What sets one single-CPU engine apart from another that shares its loop
+// (nonpreemptive_engine or preemptive_engine). Each engine passes one of the
+// static const tables next to it; the skeletons are ENGINE_INLINE, so every
+// member is a constant in the copy the engine gets and no call in its loop is
+// indirect. A new policy is a new table plus a few-line engine function.
+typedef struct
+{
+    JobRank rank;                // Key of an admitted job, lower first (context: the policy context)
+    HeapBefore before;           // Ready heap order over pool slots (context: the JobPool)
+    int scan;                    // Keep the ready set in an AgingScanSet and score every job at each pick (aging only;
+                                 // context: the AgingWeights)
+    const char *complete_format; // Completion trace line (%lld = time)
+    // Dispatch trace line for a process started at `time` after waiting `waited`
+    void (*trace_start)(const void *context, const Process *process, SimTime time, SimTime waited);
+} SchedulePolicy;
+
+// Per-run scratch memory. While an arena is active on a thread (see
+// scratch_arena_activate), the engines' pools, queues and heaps are bump
+// allocations from it and freeing them does nothing; scratch_arena_reset()
+// then rewinds it for the next run. A run that outgrows the current block
+// spills into a new one, and the next reset merges them into a single block,
+// so repeated runs of a similar size stop calling malloc altogether.
+typedef struct ScratchBlock ScratchBlock;
+struct ScratchBlock
+{
+    ScratchBlock *next; // Older, fuller block
+    size_t size;        // Usable bytes after the header
+    size_t used;
+};
+
+typedef struct
+{
+    ScratchBlock *blocks; // Current block first (NULL until the first allocation)
+    void *last;           // Most recent allocation (the only one that can grow in place)
+    size_t last_size;
+    int allocations;      // malloc calls made so far (stays put once runs fit)
+} ScratchArena;
+
+// Ready set for exhaustive aging selection, as structure of arrays: each
+// input of the score has a contiguous array of its own, so the scoring kernel
+// (aging_scan_select) loads a vector of candidates per instruction. Candidates
+// stay in arrival order (removal shifts the rest down), the order in which the
+// original selection loop visited them.
+typedef struct
+{
+    double *arrival;  // arrival_time of each candidate
+    double *burst;    // burst_time
+    double *priority; // priority
+    int *slot;        // JobPool slot
+    int size;
+    int capacity;
+} AgingScanSet;
+
 // ============================================
 // FUNCTION PROTOTYPES
 // ============================================
 
+// --- Process Table ---
+void init_process_table(ProcessTable *table);
+int reserve_process_table(ProcessTable *table, int capacity);
+void free_process_table(ProcessTable *table);
+
+// --- Scratch Memory (per-thread arena for engine state) ---
+void scratch_arena_init(ScratchArena *arena);
+void scratch_arena_free(ScratchArena *arena);
+void scratch_arena_reset(ScratchArena *arena);
+ScratchArena *scratch_arena_activate(ScratchArena *arena);
+size_t scratch_arena_used(const ScratchArena *arena);
+void *scratch_alloc(size_t size);
+void *scratch_grow(void *ptr, size_t old_size, size_t new_size);
+void scratch_free(void *ptr);
+
+// --- Ready Queues ---
+int ring_queue_init(RingQueue *queue, int capacity);
+void ring_queue_free(RingQueue *queue);
+void ring_queue_push(RingQueue *queue, int index);
+int ring_queue_pop(RingQueue *queue);
+int index_heap_init(IndexHeap *heap, int capacity, HeapBefore before, const void *context);
+void index_heap_free(IndexHeap *heap);
+void index_heap_push(IndexHeap *heap, int index);
+int index_heap_pop(IndexHeap *heap);
+int aging_scan_init(AgingScanSet *set, int capacity);
+void aging_scan_free(AgingScanSet *set);
+void aging_scan_push(AgingScanSet *set, const Process *process, int slot);
+int aging_scan_select(const AgingScanSet *set, SimTime time, const AgingWeights *weights);
+int aging_scan_remove(AgingScanSet *set, int pos);
+
+// --- Engine Support ---
+void process_source_init(ProcessSource *source, ProcessSourceRead read, void *context);
+void process_source_init_array(ProcessSource *source, ArraySourceContext *context, const Process processes[], int n);
+int process_source_read_file(void *context, Process *out);
+const Process *process_source_peek(const ProcessSource *source);
+int process_source_take(ProcessSource *source, Process *out);
+void job_pool_init(JobPool *pool);
+void job_pool_free(JobPool *pool);
+int job_pool_acquire(JobPool *pool);
+void job_pool_release(JobPool *pool, int slot);
+void job_pool_set_rank(JobPool *pool, JobRank rank, const void *context);
+void job_pool_rank(JobPool *pool, int slot);
+void gantt_timeline_init(GanttTimeline *timeline, const ScheduleListener *listener, int merge);
+
+// --- Gantt Sinks ---
+void gantt_sink_emit(GanttSink *sink, const GanttBlock *block);
+void gantt_sink_init_summary(GanttSink *sink);
+void gantt_sink_init_buffer(GanttSink *sink, GanttBuffer *buffer);
+void gantt_sink_init_file(GanttSink *sink, FILE *file);
+void gantt_sink_init_lanes(GanttSink *sink, GanttSink lanes[]);
+void gantt_sink_count_switch(GanttSink *sink, int core);
+void gantt_buffer_free(GanttBuffer *buffer);
+void gantt_timeline_append(GanttTimeline *timeline, int pid, SimTime start_time, SimTime end_time);
+void gantt_timeline_flush(GanttTimeline *timeline);
+
 // --- File Input ---
-int read_processes_from_file(const char *filename, Process processes[]);
+int process_reader_open(ProcessReader *reader, const char *filename);
+int process_reader_next(ProcessReader *reader, Process *out);
+void process_reader_close(ProcessReader *reader);
+int read_processes_from_file(const char *filename, ProcessTable *table);
+int is_binary_trace_file(const char *filename);
+int map_file(const char *filename, MappedFile *map);
+void unmap_file(MappedFile *map);
+int read_processes_from_binary(const char *filename, ProcessTable *table);
+int write_processes_binary(const char *filename, const Process processes[], int n, uint32_t field_mask);
+int convert_csv_to_binary(const char *csv_filename, const char *binary_filename);
+int write_processes_csv(const char *filename, const Process processes[], int n);
 
 // --- Utility Functions ---
 void reset_processes(Process processes[], int n);
 void copy_processes(Process source[], Process dest[], int n);
+uint64_t process_table_digest(const Process processes[], int n);
 void sort_by_arrival(Process processes[], int n);
 void sort_by_burst(Process processes[], int n);
 void sort_by_priority(Process processes[], int n);
 
 // --- Calculation & Display ---
-void calculate_metrics(Process processes[], int n, float *avg_wt, float *avg_tat);
-void display_results(Process processes[], int n);
+int compute_schedule_metrics(const Process processes[], int n, ScheduleMetrics *metrics);
+void metrics_accumulator_init(MetricsAccumulator *accumulator);
+void metrics_accumulator_add(MetricsAccumulator *accumulator, const Process *process);
+void metrics_accumulator_finish(const MetricsAccumulator *accumulator, ScheduleMetrics *metrics);
+void display_latency_metrics(const ScheduleMetrics *metrics);
+void display_results(const Process processes[], int n);
 void display_gantt_chart(GanttBlock gantt[], int gantt_size);
-void calculate_and_display_cpu_utilization(GanttBlock gantt[], int gantt_size);
+int write_gantt_svg(const char *filename, const GanttBuffer charts[], int lanes);
+void calculate_and_display_cpu_utilization(const GanttSink *gantt);
+void display_core_utilization(const GanttSink lanes[], int cores, int switch_cost);
+void display_engine_stats(const EngineStats *stats);
+
+// --- Results Output (CSV / JSON Lines) ---
+int results_writer_open(ResultsWriter *writer, FILE *out, int format);
+void results_writer_close(ResultsWriter *writer);
+void results_begin_run(ResultsWriter *writer, const char *algorithm, int quantum, int cores, int switch_cost);
+void gantt_sink_init_results(GanttSink *sink, ResultsWriter *writer);
+void results_write_process(ResultsWriter *writer, const Process *process);
+void results_write_processes(ResultsWriter *writer, const Process processes[], int n);
+void results_write_summary(ResultsWriter *writer, const GanttSink *gantt, int cores, const ScheduleMetrics *metrics);
+void results_write_sweep(ResultsWriter *writer, const SweepResult *result);
+void results_write_stats(ResultsWriter *writer, const EngineStats *stats);
+
+// --- Scheduling Engines (pull arrivals from a source, report to a listener) ---
+// Each returns the peak number of jobs it held in memory at once
+int round_robin_engine(ProcessSource *source, int quantum, const ScheduleListener *listener);
+int aging_engine(ProcessSource *source, const AgingWeights *weights, int selection, const ScheduleListener *listener);
+int sjf_engine(ProcessSource *source, const ScheduleListener *listener);
+int srtf_engine(ProcessSource *source, const ScheduleListener *listener);
+int priority_engine(ProcessSource *source, const ScheduleListener *listener);
+int mlfq_engine(ProcessSource *source, const MlfqConfig *config, const ScheduleListener *listener);
+int multicore_engine(ProcessSource *source, const MulticoreConfig *config, const ScheduleListener *listener);
+
+// --- Parameter Sweeps (configurations run in parallel over a shared, read-only table) ---
+int default_sweep_threads(void);
+void run_sweep_config(const Process processes[], int n, const SweepConfig *config, SweepResult *result);
+int run_sweep(const Process processes[], int n, const SweepConfig configs[], SweepResult results[],
+              int config_count, int threads);
+void default_aging_weights(AgingWeights *weights);
+int search_aging_weights(const Process processes[], int n, const SweepConfig *base, int objective, int threads,
+                         AgingWeights *best, SweepResult *best_result);
+
+// --- Distributed Sweeps (one sweep's batches shared out through a work directory) ---
+int sweep_plan_init(SweepPlan *plan, const char *trace, const Process processes[], int n, SweepConfig configs[],
+                    int config_count, int batch_size);
+int sweep_plan_batches(const SweepPlan *plan);
+int sweep_plan_write(const char *dir, const SweepPlan *plan);
+int sweep_plan_read(const char *dir, SweepPlan *plan);
+void sweep_plan_free(SweepPlan *plan);
+int sweep_work_batches(const char *dir, const SweepPlan *plan, const Process processes[], int n, int threads);
+int sweep_collect_results(const char *dir, const SweepPlan *plan, SweepResult results[], char done[]);
+int coordinate_sweep(const char *dir, const SweepPlan *plan, const Process processes[], int n,
+                     SweepResult results[], int threads, int claim_timeout, int verbose);
+void sweep_sleep(int seconds);
+
+// --- Synthetic Workloads & Benchmarking ---
+void default_workload_config(WorkloadConfig *config, int count);
+int generate_workload(const WorkloadConfig *config, ProcessTable *table);
+double benchmark_clock(void);
+
+// --- Golden Runs (schedule fingerprints for regression checks) ---
+void golden_digest_init(GoldenDigest *digest);
+void golden_digest_free(GoldenDigest *digest);
+void golden_run_init(GoldenRun *run);
+void golden_run_free(GoldenRun *run);
+int golden_run(const Process processes[], int n, const SweepConfig *config, GoldenRun *run);
+int golden_run_compare(const GoldenRun *expected, const GoldenRun *actual, char *why, size_t size);
+void golden_case_write(FILE *file, const GoldenCase *golden);
+int golden_case_read(FILE *file, GoldenCase *golden);
+
+// --- Incremental Re-simulation (restart an edited run from a snapshot) ---
+void recorded_run_init(RecordedRun *run, SimTime snapshot_interval);
+void recorded_run_free(RecordedRun *run);
+int first_changed_process(const Process a[], int a_count, const Process b[], int b_count);
+int record_run(const Process processes[], int n, const SweepConfig *config, RecordedRun *run);
+int resimulate(const RecordedRun *base, const Process processes[], int n, RecordedRun *run);
 
 // --- Scheduling Algorithms ---
 // PREEMPTIVE (choose 1 to implement)
-void preemptive_algorithm(Process processes[], int n, GanttBlock gantt[], int *gantt_size);
+void preemptive_algorithm(Process processes[], int n, int quantum, GanttSink *gantt);
+void srtf_algorithm(Process processes[], int n, GanttSink *gantt);
+void preemptive_priority_algorithm(Process processes[], int n, GanttSink *gantt);
+void default_mlfq_config(MlfqConfig *config);
+void mlfq_algorithm(Process processes[], int n, const MlfqConfig *config, GanttSink *gantt);
 // Options: SRTF, Preemptive Priority, Round Robin
 
 // NON-PREEMPTIVE (choose 2 to implement)
-void modified_FCFS_with_aging(Process processes[], int n, GanttBlock gantt[], int *gantt_size);
-void non_preemptive_algorithm_2(Process processes[], int n, GanttBlock gantt[], int *gantt_size);
+void modified_FCFS_with_aging(Process processes[], int n, const AgingWeights *weights, int selection, GanttSink *gantt);
+void non_preemptive_algorithm_2(Process processes[], int n, GanttSink *gantt);
 // Options: FCFS, SJF, Non-preemptive Priority
 
+// MULTI-CPU (any of the above on config->cores CPUs)
+void multicore_algorithm(Process processes[], int n, const MulticoreConfig *config, GanttSink *gantt);
+
 // ============================================
 // FUNCTION IMPLEMENTATIONS
 // ============================================
 
-// --- File Input ---
-int read_processes_from_file(const char *filename, Process processes[])
+// --- Process Table ---
+
+// Start with an empty table (no allocation until the first load)
+void init_process_table(ProcessTable *table)
 {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL)
+    table->items = NULL;
+    table->count = 0;
+    table->capacity = 0;
+}
+
+// Make sure the table can hold at least `capacity` processes
+// Returns 0 on success, -1 if the allocation failed (table is left untouched)
+int reserve_process_table(ProcessTable *table, int capacity)
+{
+    if (capacity <= table->capacity)
+        return 0;
+
+    Process *items = (Process *)realloc(table->items, (size_t)capacity * sizeof(Process));
+    if (items == NULL)
     {
-        printf("Error: Could not open file '%s'\n", filename);
+        printf("Error: Could not allocate memory for %d processes\n", capacity);
         return -1;
     }
 
-    int count = 0;
-    char line[MAX_LINE_LENGTH];
+    table->items = items;
+    table->capacity = capacity;
+    return 0;
+}
+
+// Release the table storage
+void free_process_table(ProcessTable *table)
+{
+    free(table->items);
+    init_process_table(table);
+}
 
-    // Skip header line if present (optional: check if first line is header)
-    // fgets(line, MAX_LINE_LENGTH, file);
+// --- Scratch Memory ---
 
-    while (fgets(line, MAX_LINE_LENGTH, file) != NULL && count < MAX_PROCESSES)
+// Grow a buffer that a running scheduler depends on; running out of memory
+// in the middle of a simulation is fatal
+static void *checked_realloc(void *ptr, size_t size)
+{
+    void *grown = realloc(ptr, size);
+    if (grown == NULL)
     {
-        // Expected format: PID, Arrival_Time, Burst_Time, Priority
-        // Priority is optional - defaults to 0 if not provided
-        int pid, arrival, burst, priority = 0;
+        printf("Error: Out of memory while scheduling (%lu bytes)\n", (unsigned long)size);
+        exit(EXIT_FAILURE);
+    }
+    return grown;
+}
 
-        int fields = sscanf(line, "%d,%d,%d,%d", &pid, &arrival, &burst, &priority);
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
 
-        if (fields >= 3)
-        { // At minimum: PID, Arrival, Burst
-            processes[count].pid = pid;
-            processes[count].arrival_time = arrival;
-            processes[count].burst_time = burst;
-            processes[count].priority = priority;
-            processes[count].remaining_time = burst;
-            processes[count].completion_time = 0;
-            processes[count].turnaround_time = 0;
-            processes[count].waiting_time = 0;
-            processes[count].started = 0;
-            processes[count].completed = 0;
-            count++;
-        }
-    }
+#define SCRATCH_ALIGN 16 // Every allocation starts on this boundary (enough for AVX2 loads)
+#define SCRATCH_HEADER ((sizeof(ScratchBlock) + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1))
 
-    fclose(file);
-    return count;
-}
+static THREAD_LOCAL ScratchArena *active_arena = NULL; // Arena of the calling thread, NULL = malloc
 
-// --- Utility Functions ---
+void scratch_arena_init(ScratchArena *arena)
+{
+    arena->blocks = NULL;
+    arena->last = NULL;
+    arena->last_size = 0;
+    arena->allocations = 0;
+}
 
-// Reset all calculated fields (use before running an algorithm)
-void reset_processes(Process processes[], int n)
+void scratch_arena_free(ScratchArena *arena)
 {
-    for (int i = 0; i < n; i++)
+    while (arena->blocks != NULL)
     {
-        processes[i].remaining_time = processes[i].burst_time;
-        processes[i].completion_time = 0;
-        processes[i].turnaround_time = 0;
-        processes[i].waiting_time = 0;
-        processes[i].started = 0;
-        processes[i].completed = 0;
+        ScratchBlock *older = arena->blocks->next;
+        free(arena->blocks);
+        arena->blocks = older;
     }
+    arena->last = NULL;
+    arena->last_size = 0;
 }
 
-// Copy process array (to preserve original data)
-void copy_processes(Process source[], Process dest[], int n)
+static ScratchBlock *scratch_block_new(ScratchArena *arena, size_t size)
 {
-    for (int i = 0; i < n; i++)
-    {
-        dest[i] = source[i];
-    }
+    ScratchBlock *block = (ScratchBlock *)malloc(SCRATCH_HEADER + size);
+    if (block == NULL)
+        return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    arena->allocations++;
+    return block;
 }
 
-// Sort by arrival time (ascending)
-void sort_by_arrival(Process processes[], int n)
+// Forget every allocation. If the last run spilled into several blocks they
+// are replaced by one block as large as all of them, which the next run of the
+// same size fits in without another malloc.
+void scratch_arena_reset(ScratchArena *arena)
 {
-    for (int i = 0; i < n - 1; i++)
+    arena->last = NULL;
+    arena->last_size = 0;
+    if (arena->blocks == NULL)
+        return;
+    if (arena->blocks->next == NULL)
     {
-        for (int j = 0; j < n - i - 1; j++)
-        {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time)
-            {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
+        arena->blocks->used = 0;
+        return;
     }
+
+    size_t total = 0;
+    for (ScratchBlock *block = arena->blocks; block != NULL; block = block->next)
+        total += block->size;
+    scratch_arena_free(arena);
+    arena->blocks = scratch_block_new(arena, total); // NULL just means the next run starts from scratch
 }
 
-// Sort by burst time (ascending) - for SJF
-void sort_by_burst(Process processes[], int n)
+// Route the calling thread's scratch_* calls to arena (NULL = back to malloc)
+// and return the arena that was active before. Everything allocated while an
+// arena is active must be released before it is deactivated or reset.
+ScratchArena *scratch_arena_activate(ScratchArena *arena)
+{
+    ScratchArena *previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+// Bytes handed out since the last reset: everything the current run allocated,
+// including buffers it has since grown out of
+size_t scratch_arena_used(const ScratchArena *arena)
 {
-    for (int i = 0; i < n - 1; i++)
+    size_t used = 0;
+    for (const ScratchBlock *block = arena->blocks; block != NULL; block = block->next)
+        used += block->used;
+    return used;
+}
+
+// malloc() semantics: NULL if the memory can't be had
+void *scratch_alloc(size_t size)
+{
+    ScratchArena *arena = active_arena;
+    if (arena == NULL)
+        return malloc(size);
+
+    size = (size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    ScratchBlock *block = arena->blocks;
+    if (block == NULL || block->size - block->used < size)
     {
-        for (int j = 0; j < n - i - 1; j++)
-        {
-            if (processes[j].burst_time > processes[j + 1].burst_time)
-            {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
+        size_t grown = block != NULL ? block->size * 2 : SCRATCH_BLOCK_SIZE;
+        if (grown < size)
+            grown = size;
+        ScratchBlock *fresh = scratch_block_new(arena, grown);
+        if (fresh == NULL)
+            return NULL;
+        fresh->next = block;
+        arena->blocks = block = fresh;
     }
+
+    void *ptr = (char *)block + SCRATCH_HEADER + block->used;
+    block->used += size;
+    arena->last = ptr;
+    arena->last_size = size;
+    return ptr;
 }
 
-// Sort by priority (ascending - lower number = higher priority)
-void sort_by_priority(Process processes[], int n)
+// Resize a scratch buffer, keeping its first old_size bytes (fatal if out of memory)
+void *scratch_grow(void *ptr, size_t old_size, size_t new_size)
 {
-    for (int i = 0; i < n - 1; i++)
+    ScratchArena *arena = active_arena;
+    if (arena == NULL)
+        return checked_realloc(ptr, new_size);
+
+    // The newest allocation can simply extend into the rest of its block
+    if (ptr != NULL && ptr == arena->last)
     {
-        for (int j = 0; j < n - i - 1; j++)
+        ScratchBlock *block = arena->blocks;
+        size_t needed = (new_size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+        if (needed <= arena->last_size)
+            return ptr;
+        if (block->size - block->used >= needed - arena->last_size)
         {
-            if (processes[j].priority > processes[j + 1].priority)
-            {
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
+            block->used += needed - arena->last_size;
+            arena->last_size = needed;
+            return ptr;
         }
     }
+
+    void *grown = scratch_alloc(new_size);
+    if (grown == NULL)
+    {
+        printf("Error: Out of memory while scheduling (%lu bytes)\n", (unsigned long)new_size);
+        exit(EXIT_FAILURE);
+    }
+    if (ptr != NULL)
+        memcpy(grown, ptr, old_size);
+    return grown;
 }
 
-// --- Calculation & Display ---
+// free() for scratch_alloc memory; arena memory is only reclaimed by a reset
+void scratch_free(void *ptr)
+{
+    if (active_arena == NULL)
+        free(ptr);
+}
+
+// --- Ready Queues ---
 
-// Calculate average waiting time and turnaround time
-void calculate_metrics(Process processes[], int n, float *avg_wt, float *avg_tat)
+// Allocate an empty ring able to hold `capacity` indices
+// Returns 0 on success, -1 if the allocation failed
+int ring_queue_init(RingQueue *queue, int capacity)
 {
-    int total_wt = 0;
-    int total_tat = 0;
+    queue->slots = (int *)scratch_alloc((size_t)(capacity > 0 ? capacity : 1) * sizeof(int));
+    queue->capacity = capacity > 0 ? capacity : 1;
+    queue->head = 0;
+    queue->size = 0;
+    return queue->slots != NULL ? 0 : -1;
+}
 
-    for (int i = 0; i < n; i++)
+void ring_queue_free(RingQueue *queue)
+{
+    scratch_free(queue->slots);
+    queue->slots = NULL;
+    queue->capacity = 0;
+    queue->head = 0;
+    queue->size = 0;
+}
+
+// Append at the tail, doubling the ring when it is full
+void ring_queue_push(RingQueue *queue, int index)
+{
+    if (queue->size == queue->capacity)
     {
-        processes[i].turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
-        total_wt += processes[i].waiting_time;
-        total_tat += processes[i].turnaround_time;
+        int *slots = (int *)scratch_grow(NULL, 0, (size_t)queue->capacity * 2 * sizeof(int));
+        for (int i = 0; i < queue->size; i++)
+            slots[i] = queue->slots[(queue->head + i) % queue->capacity];
+        scratch_free(queue->slots);
+        queue->slots = slots;
+        queue->capacity *= 2;
+        queue->head = 0;
     }
 
-    *avg_wt = (float)total_wt / n;
-    *avg_tat = (float)total_tat / n;
+    int tail = queue->head + queue->size;
+    if (tail >= queue->capacity)
+        tail -= queue->capacity;
+    queue->slots[tail] = index;
+    queue->size++;
+    STAT_ADD(queue_ops, 1);
 }
 
-// Display process table with results
-void display_results(Process processes[], int n)
+// Remove from the head (caller guarantees size > 0)
+int ring_queue_pop(RingQueue *queue)
 {
-    float avg_wt, avg_tat;
-    calculate_metrics(processes, n, &avg_wt, &avg_tat);
-    printf("\n");
-    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
-    printf("| PID |  Arrival | Burst | Priority | Completion | Turnaround |  Waiting |\n");
-    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
-
-    for (int i = 0; i < n; i++)
-    {
-        printf("| %3d | %8d | %5d | %8d | %10d | %10d | %8d |\n",
-               processes[i].pid,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].priority,
-               processes[i].completion_time,
-               processes[i].turnaround_time,
-               processes[i].waiting_time);
-    }
+    int index = queue->slots[queue->head];
+    queue->head++;
+    if (queue->head == queue->capacity)
+        queue->head = 0;
+    queue->size--;
+    STAT_ADD(queue_ops, 1);
+    STAT_ADD(selections, 1);
+    STAT_ADD(candidates, 1);
+    return index;
+}
 
-    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
+// Allocate an empty heap able to hold `capacity` indices
+// Returns 0 on success, -1 if the allocation failed
+int index_heap_init(IndexHeap *heap, int capacity, HeapBefore before, const void *context)
+{
+    heap->items = (int *)scratch_alloc((size_t)(capacity > 0 ? capacity : 1) * sizeof(int));
+    heap->capacity = capacity > 0 ? capacity : 1;
+    heap->size = 0;
+    heap->before = before;
+    heap->context = context;
+    return heap->items != NULL ? 0 : -1;
+}
 
-    calculate_metrics(processes, n, &avg_wt, &avg_tat);
-    printf("\nAverage Waiting Time: %.2f\n", avg_wt);
-    printf("Average Turnaround Time: %.2f\n", avg_tat);
+void index_heap_free(IndexHeap *heap)
+{
+    scratch_free(heap->items);
+    heap->items = NULL;
+    heap->capacity = 0;
+    heap->size = 0;
 }
 
-// Display Gantt chart (including idle times)
-void display_gantt_chart(GanttBlock gantt[], int gantt_size)
+// Insert an index, doubling the heap when it is full. The sift loops take the
+// ordering rule as an argument so an engine skeleton can hand them a constant one.
+ENGINE_INLINE void heap_sift_push(IndexHeap *heap, int index, HeapBefore before)
 {
-    if (gantt_size == 0)
+    if (heap->size == heap->capacity)
     {
-        printf("\nNo Gantt chart data to display.\n");
-        return;
+        heap->items = (int *)scratch_grow(heap->items, (size_t)heap->capacity * sizeof(int),
+                                          (size_t)heap->capacity * 2 * sizeof(int));
+        heap->capacity *= 2;
     }
 
-    printf("\n===== GANTT CHART =====\n\n");
-
-    // Top border
-    printf(" ");
-    for (int i = 0; i < gantt_size; i++)
+    int pos = heap->size++;
+    while (pos > 0)
     {
-        int width = (gantt[i].end_time - gantt[i].start_time) * 2;
-        if (width < 4)
-            width = 4;
-        for (int j = 0; j < width; j++)
-            printf("-");
-        printf(" ");
+        int parent = (pos - 1) / 2;
+        if (!before(heap->context, index, heap->items[parent]))
+            break;
+        heap->items[pos] = heap->items[parent];
+        pos = parent;
     }
-    printf("\n|");
+    heap->items[pos] = index;
+    STAT_ADD(queue_ops, 1);
+}
 
-    // Process IDs
-    for (int i = 0; i < gantt_size; i++)
-    {
-        int width = (gantt[i].end_time - gantt[i].start_time) * 2;
-        if (width < 4)
-            width = 4;
-        if (gantt[i].pid == -1)
-        {
-            // Idle time
-            printf("%*s|", width, "IDLE");
-        }
-        else
-        {
-            printf(" P%-*d|", width - 2, gantt[i].pid);
-        }
-    }
-    printf("\n ");
+// Remove and return the index that must be served first (caller guarantees size > 0)
+ENGINE_INLINE int heap_sift_pop(IndexHeap *heap, HeapBefore before)
+{
+    int top = heap->items[0];
+    int last = heap->items[--heap->size];
+    int pos = 0;
+    int compared = 1; // the top itself
 
-    // Bottom border
-    for (int i = 0; i < gantt_size; i++)
+    while (1)
     {
-        int width = (gantt[i].end_time - gantt[i].start_time) * 2;
-        if (width < 4)
-            width = 4;
-        for (int j = 0; j < width; j++)
-            printf("-");
-        printf(" ");
+        int child = 2 * pos + 1;
+        if (child >= heap->size)
+            break;
+        compared += child + 1 < heap->size ? 2 : 1;
+        if (child + 1 < heap->size && before(heap->context, heap->items[child + 1], heap->items[child]))
+            child++;
+        if (!before(heap->context, heap->items[child], last))
+            break;
+        heap->items[pos] = heap->items[child];
+        pos = child;
     }
-    printf("\n");
+    if (heap->size > 0)
+        heap->items[pos] = last;
 
-    // Time markers
-    printf("%d", gantt[0].start_time);
-    for (int i = 0; i < gantt_size; i++)
-    {
-        int width = (gantt[i].end_time - gantt[i].start_time) * 2;
-        if (width < 4)
-            width = 4;
-        printf("%*d", width + 1, gantt[i].end_time);
-    }
-    printf("\n");
+    STAT_ADD(queue_ops, 1);
+    STAT_ADD(selections, 1);
+    STAT_ADD(candidates, compared);
+    (void)compared;
+    return top;
 }
 
-// Calculate and display CPU utilization
-void calculate_and_display_cpu_utilization(GanttBlock gantt[], int gantt_size)
+void index_heap_push(IndexHeap *heap, int index)
 {
-    if (gantt_size == 0)
+    heap_sift_push(heap, index, heap->before);
+}
+
+int index_heap_pop(IndexHeap *heap)
+{
+    return heap_sift_pop(heap, heap->before);
+}
+
+// --- Aging Scan Set ---
+
+// Allocate an empty set able to hold `capacity` candidates
+// Returns 0 on success, -1 if the allocation failed
+int aging_scan_init(AgingScanSet *set, int capacity)
+{
+    set->capacity = capacity > 0 ? capacity : 1;
+    set->size = 0;
+    set->arrival = (double *)scratch_alloc((size_t)set->capacity * sizeof(double));
+    set->burst = (double *)scratch_alloc((size_t)set->capacity * sizeof(double));
+    set->priority = (double *)scratch_alloc((size_t)set->capacity * sizeof(double));
+    set->slot = (int *)scratch_alloc((size_t)set->capacity * sizeof(int));
+    if (set->arrival == NULL || set->burst == NULL || set->priority == NULL || set->slot == NULL)
     {
-        printf("CPU Utilization: N/A (no Gantt data)\n");
-        return;
+        aging_scan_free(set);
+        return -1;
     }
+    return 0;
+}
 
-    int total_time = gantt[gantt_size - 1].end_time - gantt[0].start_time;
-    int idle_time = 0;
+void aging_scan_free(AgingScanSet *set)
+{
+    scratch_free(set->arrival);
+    scratch_free(set->burst);
+    scratch_free(set->priority);
+    scratch_free(set->slot);
+    set->arrival = set->burst = set->priority = NULL;
+    set->slot = NULL;
+    set->capacity = 0;
+    set->size = 0;
+}
 
-    // Calculate total idle time
-    for (int i = 0; i < gantt_size; i++)
+// Add a candidate after every other (candidates arrive in arrival order),
+// doubling every array when the set is full
+void aging_scan_push(AgingScanSet *set, const Process *process, int slot)
+{
+    if (set->size == set->capacity)
     {
-        if (gantt[i].pid == -1)
-        {
-            idle_time += (gantt[i].end_time - gantt[i].start_time);
-        }
+        int grown = set->capacity * 2;
+        size_t old = (size_t)set->capacity * sizeof(double);
+        size_t size = (size_t)grown * sizeof(double);
+        set->arrival = (double *)scratch_grow(set->arrival, old, size);
+        set->burst = (double *)scratch_grow(set->burst, old, size);
+        set->priority = (double *)scratch_grow(set->priority, old, size);
+        set->slot = (int *)scratch_grow(set->slot, (size_t)set->capacity * sizeof(int), (size_t)grown * sizeof(int));
+        set->capacity = grown;
     }
 
-    int busy_time = total_time - idle_time;
-    float cpu_utilization = (total_time > 0) ? ((float)busy_time / total_time) * 100.0 : 0.0;
-
-    printf("\n===== CPU UTILIZATION =====\n");
-    printf("Total Time: %d\n", total_time);
-    printf("Busy Time: %d\n", busy_time);
-    printf("Idle Time: %d\n", idle_time);
-    printf("CPU Utilization: %.2f%%\n", cpu_utilization);
+    int i = set->size++;
+    set->arrival[i] = (double)process->arrival_time;
+    set->burst[i] = (double)process->burst_time;
+    set->priority[i] = (double)process->priority;
+    set->slot[i] = slot;
+    STAT_ADD(queue_ops, 1);
 }
-// ============================================
-// SCHEDULING ALGORITHMS (STUBS - TO BE IMPLEMENTED)
-// ============================================
 
-/*
- * PREEMPTIVE ALGORITHM
- * ---------------------
- * TODO: Implement ONE of the following:
- *   - SRTF (Shortest Remaining Time First)
- *   - Preemptive Priority
- *   - Round Robin (requires time quantum)
- *
- * Remember to:
- *   1. Handle idle time when no process is available
- *   2. Update the Gantt chart array
- *   3. Set completion_time for each process
- */
-void preemptive_algorithm(Process processes[], int n, GanttBlock gantt[], int *gantt_size)
+// Remove the candidate at pos, keeping the others in order; returns its slot
+int aging_scan_remove(AgingScanSet *set, int pos)
 {
-    printf("\n===== PREEMPTIVE ROUND ROBIN ALGORITHM =====\n");
+    int slot = set->slot[pos];
+    size_t after = (size_t)(set->size - pos - 1);
+    memmove(set->arrival + pos, set->arrival + pos + 1, after * sizeof(double));
+    memmove(set->burst + pos, set->burst + pos + 1, after * sizeof(double));
+    memmove(set->priority + pos, set->priority + pos + 1, after * sizeof(double));
+    memmove(set->slot + pos, set->slot + pos + 1, after * sizeof(int));
+    set->size--;
+    STAT_ADD(queue_ops, 1);
+    return slot;
+}
 
-    int quantum;
-    printf("Enter time quantum: ");
-    scanf("%d", &quantum);
-    if (quantum <= 0)
+// The original selection rule for candidate i with score `score` against the
+// best so far (*best = -1: none yet): a clearly higher score wins, and of
+// scores within AGING_SCORE_EPSILON the earlier arrival wins
+static inline void aging_scan_consider(const AgingScanSet *set, int i, double score, int *best, double *best_score)
+{
+    if (*best == -1 || score > *best_score + AGING_SCORE_EPSILON)
     {
-        printf("Invalid quantum, defaulting to 1.\n");
-        quantum = 1;
+        *best_score = score;
+        *best = i;
     }
-
-    int time = 0;
-    int completed = 0;
-
-    // Start at earliest arrival (avoid initial negative idle if arrivals start later)
-    int earliest_arrival = processes[0].arrival_time;
-    for (int i = 1; i < n; i++)
+    else if (fabs(score - *best_score) <= AGING_SCORE_EPSILON && set->arrival[i] < set->arrival[*best])
     {
-        if (processes[i].arrival_time < earliest_arrival)
-            earliest_arrival = processes[i].arrival_time;
+        *best_score = score;
+        *best = i;
     }
-    if (time < earliest_arrival)
-        time = earliest_arrival;
-
-    int queue[MAX_PROCESSES * 10];
-    int front = 0, rear = 0;
-    int in_queue[MAX_PROCESSES] = {0};
+}
 
-    *gantt_size = 0;
+// Position of the candidate to run at `time` (caller guarantees size > 0).
+// Every candidate is scored as
+//     score = (time - arrival) * weights.aging - burst * weights.burst - priority * weights.priority
+// and picked with a running best in arrival order (aging_scan_consider), so
+// the pick is exactly the one the original selection loop made. Scores are
+// computed 4 (AVX2) or 2 (NEON) per instruction, in the same operation order
+// as the scalar formula; a block is only walked lane by lane when one of its
+// candidates could replace the best so far, which is rare once the best is
+// found. The tail is scored one by one.
+int aging_scan_select(const AgingScanSet *set, SimTime time, const AgingWeights *weights)
+{
+    int n = set->size;
+    double now = (double)time;
+    int best = -1;
+    double best_score = 0.0;
+    aging_scan_consider(set, 0,
+                        (now - set->arrival[0]) * weights->aging - set->burst[0] * weights->burst -
+                            set->priority[0] * weights->priority,
+                        &best, &best_score);
+    int i = 1;
 
-    while (completed < n)
+#if defined(__AVX2__)
+    const __m256d v_now = _mm256_set1_pd(now);
+    const __m256d v_aging = _mm256_set1_pd(weights->aging);
+    const __m256d v_burst = _mm256_set1_pd(weights->burst);
+    const __m256d v_priority = _mm256_set1_pd(weights->priority);
+    const __m256d v_epsilon = _mm256_set1_pd(AGING_SCORE_EPSILON);
+    const __m256d v_sign = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= n; i += 4)
     {
-        // 1. Enqueue all processes that have already arrived
-        for (int i = 0; i < n; i++)
+        __m256d arrival = _mm256_loadu_pd(set->arrival + i);
+        __m256d score = _mm256_sub_pd(
+            _mm256_sub_pd(_mm256_mul_pd(_mm256_sub_pd(v_now, arrival), v_aging),
+                          _mm256_mul_pd(_mm256_loadu_pd(set->burst + i), v_burst)),
+            _mm256_mul_pd(_mm256_loadu_pd(set->priority + i), v_priority));
+
+        // Lanes that could replace the best: clearly higher, or tied and earlier
+        __m256d v_best = _mm256_set1_pd(best_score);
+        __m256d higher = _mm256_cmp_pd(score, _mm256_add_pd(v_best, v_epsilon), _CMP_GT_OQ);
+        __m256d tied = _mm256_cmp_pd(_mm256_andnot_pd(v_sign, _mm256_sub_pd(score, v_best)), v_epsilon, _CMP_LE_OQ);
+        __m256d earlier = _mm256_cmp_pd(arrival, _mm256_set1_pd(set->arrival[best]), _CMP_LT_OQ);
+        if (_mm256_movemask_pd(_mm256_or_pd(higher, _mm256_and_pd(tied, earlier))) != 0)
         {
-            if (!processes[i].completed &&
-                processes[i].arrival_time <= time &&
-                processes[i].remaining_time > 0 &&
-                !in_queue[i])
-            {
-                queue[rear++] = i;
-                in_queue[i] = 1;
-            }
+            double scores[4];
+            _mm256_storeu_pd(scores, score);
+            for (int k = 0; k < 4; k++)
+                aging_scan_consider(set, i + k, scores[k], &best, &best_score);
         }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float64x2_t v_now = vdupq_n_f64(now);
+    const float64x2_t v_aging = vdupq_n_f64(weights->aging);
+    const float64x2_t v_burst = vdupq_n_f64(weights->burst);
+    const float64x2_t v_priority = vdupq_n_f64(weights->priority);
+    const float64x2_t v_epsilon = vdupq_n_f64(AGING_SCORE_EPSILON);
+    for (; i + 2 <= n; i += 2)
+    {
+        float64x2_t arrival = vld1q_f64(set->arrival + i);
+        float64x2_t score = vsubq_f64(vsubq_f64(vmulq_f64(vsubq_f64(v_now, arrival), v_aging),
+                                                vmulq_f64(vld1q_f64(set->burst + i), v_burst)),
+                                      vmulq_f64(vld1q_f64(set->priority + i), v_priority));
 
-        // 2. If no one is ready, CPU idle until next arrival
-        if (front == rear)
+        // Lanes that could replace the best: clearly higher, or tied and earlier
+        float64x2_t v_best = vdupq_n_f64(best_score);
+        uint64x2_t higher = vcgtq_f64(score, vaddq_f64(v_best, v_epsilon));
+        uint64x2_t tied = vcleq_f64(vabdq_f64(score, v_best), v_epsilon);
+        uint64x2_t earlier = vcltq_f64(arrival, vdupq_n_f64(set->arrival[best]));
+        uint64x2_t replace = vorrq_u64(higher, vandq_u64(tied, earlier));
+        if ((vgetq_lane_u64(replace, 0) | vgetq_lane_u64(replace, 1)) != 0)
         {
-            int next_arrival = 1000000000;
-            for (int i = 0; i < n; i++)
-            {
-                if (!processes[i].completed &&
-                    processes[i].arrival_time > time &&
-                    processes[i].arrival_time < next_arrival)
-                {
-                    next_arrival = processes[i].arrival_time;
-                }
-            }
-
-            if (next_arrival == 1000000000)
-                break; // no more work
-
-            // Add/extend IDLE block in Gantt chart
-            if (*gantt_size > 0 &&
-                gantt[*gantt_size - 1].pid == -1 &&
-                gantt[*gantt_size - 1].end_time == time)
-            {
-                // extend existing idle block
-                gantt[*gantt_size - 1].end_time = next_arrival;
-            }
-            else
-            {
-                gantt[*gantt_size].pid = -1;
-                gantt[*gantt_size].start_time = time;
-                gantt[*gantt_size].end_time = next_arrival;
-                (*gantt_size)++;
-            }
-
-            printf("[IDLE] Time %d -> %d\n", time, next_arrival);
-            time = next_arrival;
-            continue;
+            double scores[2];
+            vst1q_f64(scores, score);
+            aging_scan_consider(set, i, scores[0], &best, &best_score);
+            aging_scan_consider(set, i + 1, scores[1], &best, &best_score);
         }
+    }
+#endif
+    for (; i < n; i++)
+        aging_scan_consider(set, i,
+                            (now - set->arrival[i]) * weights->aging - set->burst[i] * weights->burst -
+                                set->priority[i] * weights->priority,
+                            &best, &best_score);
 
-        // 3. Dequeue next process
-        int idx = queue[front++];
-        in_queue[idx] = 0;
-        Process *p = &processes[idx];
-
-        if (p->completed || p->remaining_time <= 0)
-            continue;
+    STAT_ADD(selections, 1);
+    STAT_ADD(candidates, n);
+    return best;
+}
 
-        if (!p->started)
-            p->started = 1;
+// --- File Input ---
 
-        int start_time = time;
+// Fill a freshly loaded process (all calculated fields cleared)
+static void init_process(Process *p, int pid, SimTime arrival, SimTime burst, int priority)
+{
+    p->pid = pid;
+    p->arrival_time = arrival;
+    p->burst_time = burst;
+    p->priority = priority;
+    p->remaining_time = burst;
+    p->completion_time = 0;
+    p->turnaround_time = -arrival; // Derived from completion_time (see reset_processes)
+    p->waiting_time = -arrival - burst;
+    p->started = 0;
+    p->first_run_time = 0;
+    p->completed = 0;
+}
 
-        int run_for = (p->remaining_time < quantum) ? p->remaining_time : quantum;
-        if (run_for <= 0)
-            continue;
+// Count newline-terminated (or trailing unterminated) lines to size the table up front
+static int count_lines_in_file(FILE *file, char *buffer, size_t buffer_size)
+{
+    size_t bytes;
+    int lines = 0;
+    int last_char = '\n';
 
-        // 4. Gantt handling: merge with previous block if same PID and contiguous
-        if (*gantt_size > 0 &&
-            gantt[*gantt_size - 1].pid == p->pid &&
-            gantt[*gantt_size - 1].end_time == time)
-        {
-            // extend previous block
-            gantt[*gantt_size - 1].end_time += run_for;
-        }
-        else
+    while ((bytes = fread(buffer, 1, buffer_size, file)) > 0)
+    {
+        const char *cursor = buffer;
+        const char *end = buffer + bytes;
+        while ((cursor = (const char *)memchr(cursor, '\n', (size_t)(end - cursor))) != NULL)
         {
-            // new time block
-            gantt[*gantt_size].pid = p->pid;
-            gantt[*gantt_size].start_time = time;
-            gantt[*gantt_size].end_time = time + run_for;
-            (*gantt_size)++;
+            lines++;
+            cursor++;
         }
+        last_char = buffer[bytes - 1];
+    }
 
-        printf("[P%d] runs from %d to %d (remaining before run: %d)\n",
-               p->pid, time, time + run_for, p->remaining_time);
+    if (last_char != '\n')
+        lines++; // last line has no trailing newline
 
-        time += run_for;
-        p->remaining_time -= run_for;
+    return lines;
+}
 
-        // 5. After advancing time, enqueue ONLY NEW arrivals that arrived during (start_time, time]
-        for (int i = 0; i < n; i++)
-        {
-            if (!processes[i].completed &&
-                processes[i].arrival_time > start_time &&
-                processes[i].arrival_time <= time &&
-                processes[i].remaining_time > 0 &&
-                !in_queue[i])
-            {
-                queue[rear++] = i;
-                in_queue[i] = 1;
-            }
-        }
+// Parse one optionally signed 64-bit decimal, skipping surrounding blanks
+// Returns a pointer just past the number, or NULL if there is none or it overflows
+static const char *parse_int_field(const char *cursor, const char *end, long long *value)
+{
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+        cursor++;
 
-        // 6. Not Finished? *insert_megamind_meme*
-        if (p->remaining_time == 0 && !p->completed)
-        {
-            p->completed = 1;
-            p->completion_time = time;
-            completed++;
-            printf("     [P%d completed at time %d]\n", p->pid, time);
-        }
-        else if (p->remaining_time > 0)
-        {
-            // Not finished: re-enqueue once at the back
-            queue[rear++] = idx;
-            in_queue[idx] = 1;
-        }
+    int negative = 0;
+    if (cursor < end && (*cursor == '-' || *cursor == '+'))
+    {
+        negative = (*cursor == '-');
+        cursor++;
     }
 
-    printf("\nAll processes reached end of Round Robin loop at time %d\n", time);
+    if (cursor == end || *cursor < '0' || *cursor > '9')
+        return NULL;
 
-    // Display CPU utilization
-    calculate_and_display_cpu_utilization(gantt, *gantt_size);
+    long long result = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9')
+    {
+        int digit = *cursor - '0';
+        if (result > (INT64_MAX - digit) / 10)
+            return NULL;
+        result = result * 10 + digit;
+        cursor++;
+    }
+
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+        cursor++;
+
+    *value = negative ? -result : result;
+    return cursor;
 }
 
-/*
- * NON-PREEMPTIVE ALGORITHM 1
- * ---------------------------
- * TODO: Implement ONE of the following:
- *   - FCFS (First Come First Serve)
- *   - SJF (Shortest Job First)
- *   - Non-preemptive Priority
- *
- * Remember to:
- *   1. Handle idle time when no process is available
- *   2. Update the Gantt chart array
- *   3. Set completion_time for each process
- */
+// Parse "PID,Arrival,Burst[,Priority]" from [line, end); PID and priority must fit an int
+// Returns the number of fields parsed (3 or 4), or 0 if the line is malformed
+static int parse_process_line(const char *line, const char *end, long long fields[4])
+{
+    const char *cursor = line;
+    int count = 0;
 
-/*
- * MODIFIED FCFS WITH AGING AND BURST-TIME AWARENESS
- * ==================================================
- * This algorithm addresses standard FCFS weaknesses:
- *
- * 1. AGING MECHANISM: Processes gain priority as they wait
- *    - Each time unit waited increases effective priority
- *    - Prevents indefinite waiting (starvation)
- *
- * 2. BURST-TIME AWARENESS: Shorter jobs get slight preference
- *    - When multiple processes have similar wait times
- *    - Reduces convoy effect without full preemption
- *
- * 3. DYNAMIC SCHEDULING: Re-evaluates at each completion
- *    - Not purely first-come (like standard FCFS)
- *    - Balances fairness with efficiency
- *
- * SCORING FORMULA:
- * score = (wait_time * AGING_WEIGHT) - (burst_time * BURST_WEIGHT) - (priority * PRIORITY_WEIGHT)
- *
- * Higher score = Higher selection priority
- */
+    fields[3] = 0; // Priority is optional - defaults to 0 if not provided
+    while (count < 4)
+    {
+        cursor = parse_int_field(cursor, end, &fields[count]);
+        if (cursor == NULL)
+            return 0;
+        count++;
+
+        if (cursor == end)
+            break;
+        if (*cursor != ',')
+            return 0;
+        cursor++;
+    }
 
-#define AGING_WEIGHT 2.0    // How much waiting time matters
-#define BURST_WEIGHT 0.5    // How much job length matters
-#define PRIORITY_WEIGHT 3.0 // How much original priority matters
+    if (cursor != end || count < 3)
+        return 0;
+    if (fields[0] < INT32_MIN || fields[0] > INT32_MAX || fields[3] < INT32_MIN || fields[3] > INT32_MAX)
+        return 0;
+    return count;
+}
 
-void modified_FCFS_with_aging(Process processes[], int n, GanttBlock gantt[], int *gantt_size)
+static void report_bad_line(ProcessReader *reader, const char *line, const char *end)
 {
-    int current_time = 0;
-    int completed = 0;
-    *gantt_size = 0;
+    reader->bad_lines++;
+    if (reader->bad_lines <= MAX_REPORTED_BAD_LINES)
+    {
+        int shown = (int)(end - line) > 40 ? 40 : (int)(end - line);
+        fprintf(stderr, "Warning: %s:%ld: skipped malformed line '%.*s%s'\n",
+                reader->filename, reader->line_number, shown, line, (end - line) > 40 ? "..." : "");
+    }
+}
 
-    printf("\n===== Modified FCFS with Aging Algorithm =====\n");
-    printf("Aging Weight: %.1f | Burst Weight: %.1f | Priority Weight: %.1f\n",
-           AGING_WEIGHT, BURST_WEIGHT, PRIORITY_WEIGHT);
+// Open a process file for block-buffered parsing
+// Returns 0 on success, -1 if the file cannot be opened or the buffer allocated
+int process_reader_open(ProcessReader *reader, const char *filename)
+{
+    reader->filename = filename;
+    reader->buffer = NULL;
+    reader->buffer_size = 0;
+    reader->length = 0;
+    reader->pos = 0;
+    reader->line_number = 0;
+    reader->at_eof = 0;
+    reader->bad_lines = 0;
+    reader->last_fields = 0;
 
-    while (completed < n)
+    reader->file = fopen(filename, "rb");
+    if (reader->file == NULL)
     {
-        // Find all processes that have arrived by current_time
-        int best_idx = -1;
-        double best_score = -999999.0;
+        printf("Error: Could not open file '%s'\n", filename);
+        return -1;
+    }
 
-        for (int i = 0; i < n; i++)
-        {
-            if (!processes[i].completed && processes[i].arrival_time <= current_time)
-            {
-                // Calculate dynamic score based on:
-                // 1. How long the process has been waiting (aging)
-                // 2. How short the burst time is (efficiency)
-                // 3. Original priority value (urgency)
+    reader->buffer = (char *)malloc(READ_BLOCK_SIZE);
+    if (reader->buffer == NULL)
+    {
+        printf("Error: Could not allocate read buffer for '%s'\n", filename);
+        fclose(reader->file);
+        reader->file = NULL;
+        return -1;
+    }
+    reader->buffer_size = READ_BLOCK_SIZE;
+    return 0;
+}
 
-                int wait_time = current_time - processes[i].arrival_time;
+// Find the next complete line, refilling the buffer as needed
+// Returns 1 with [*line, *end) set (newline excluded), 0 at end of file
+static int next_line(ProcessReader *reader, const char **line, const char **end)
+{
+    while (1)
+    {
+        char *start = reader->buffer + reader->pos;
+        size_t available = reader->length - reader->pos;
+        char *newline = (char *)memchr(start, '\n', available);
 
-                double score = (wait_time * AGING_WEIGHT) - (processes[i].burst_time * BURST_WEIGHT) - (processes[i].priority * PRIORITY_WEIGHT);
+        if (newline != NULL || (reader->at_eof && available > 0))
+        {
+            char *stop = newline != NULL ? newline : start + available;
+            reader->pos = (size_t)(stop - reader->buffer) + (newline != NULL ? 1 : 0);
+            reader->line_number++;
 
-                // Tie-breaker: if scores are very close, use arrival time (pure FCFS)
-                if (best_idx == -1 || score > best_score + 0.001)
-                {
-                    best_score = score;
-                    best_idx = i;
-                }
-                else if (fabs(score - best_score) <= 0.001)
-                {
-                    // Scores essentially equal - use arrival time as tie-breaker
-                    if (processes[i].arrival_time < processes[best_idx].arrival_time)
-                    {
-                        best_score = score;
-                        best_idx = i;
-                    }
-                }
-            }
+            if (stop > start && stop[-1] == '\r')
+                stop--; // Windows line endings
+            *line = start;
+            *end = stop;
+            return 1;
         }
+        if (reader->at_eof)
+            return 0;
 
-        if (best_idx == -1)
+        // Carry the partial line to the front, growing the buffer for very long lines
+        memmove(reader->buffer, start, available);
+        reader->length = available;
+        reader->pos = 0;
+        if (reader->length == reader->buffer_size)
         {
-            // No process available - CPU idle
-            int next_arrival = 999999;
-            for (int i = 0; i < n; i++)
-            {
-                if (!processes[i].completed && processes[i].arrival_time > current_time)
-                {
-                    if (processes[i].arrival_time < next_arrival)
-                    {
-                        next_arrival = processes[i].arrival_time;
-                    }
-                }
-            }
-
-            if (next_arrival != 999999)
+            char *grown = (char *)realloc(reader->buffer, reader->buffer_size * 2);
+            if (grown == NULL)
             {
-                // Add idle block to Gantt chart
-                gantt[*gantt_size].pid = -1;
-                gantt[*gantt_size].start_time = current_time;
-                gantt[*gantt_size].end_time = next_arrival;
-                (*gantt_size)++;
-
-                printf("[IDLE] Time %d -> %d (waiting for next arrival)\n",
-                       current_time, next_arrival);
-                current_time = next_arrival;
+                fprintf(stderr, "Warning: %s:%ld: line too long, stopping\n",
+                        reader->filename, reader->line_number + 1);
+                return 0;
             }
+            reader->buffer = grown;
+            reader->buffer_size *= 2;
         }
-        else
-        {
-            // Execute the selected process to completion
-            Process *p = &processes[best_idx];
 
-            int wait_time = current_time - p->arrival_time;
-            printf("[P%d] Start: %d | Waited: %d | Burst: %d | Score: %.2f\n",
-                   p->pid, current_time, wait_time, p->burst_time, best_score);
+        size_t bytes = fread(reader->buffer + reader->length, 1, reader->buffer_size - reader->length, reader->file);
+        reader->length += bytes;
+        if (bytes == 0)
+            reader->at_eof = 1;
+    }
+}
 
-            // Add to Gantt chart
-            gantt[*gantt_size].pid = p->pid;
-            gantt[*gantt_size].start_time = current_time;
-            gantt[*gantt_size].end_time = current_time + p->burst_time;
-            (*gantt_size)++;
+// Read the next valid process record
+// Blank lines and a non-numeric first line (header) are skipped silently;
+// any other unparsable line is reported with its line number and skipped.
+// Returns 1 if *out was filled, 0 at end of file
+int process_reader_next(ProcessReader *reader, Process *out)
+{
+    const char *line, *end;
 
-            // Update process
-            current_time += p->burst_time;
-            p->completion_time = current_time;
-            p->completed = 1;
-            completed++;
+    while (next_line(reader, &line, &end))
+    {
+        const char *first = line;
+        while (first < end && (*first == ' ' || *first == '\t'))
+            first++;
+        if (first == end)
+            continue; // blank line
 
-            printf("     Complete: %d\n", current_time);
+        long long fields[4];
+        int parse_fields = parse_process_line(line, end, fields);
+        if (parse_fields == 0)
+        {
+            int is_header = reader->line_number == 1 &&
+                            !(*first >= '0' && *first <= '9') && *first != '-' && *first != '+';
+            if (!is_header)
+                report_bad_line(reader, line, end);
+            continue;
         }
+
+        init_process(out, (int)fields[0], fields[1], fields[2], (int)fields[3]);
+        reader->last_fields = parse_fields;
+        return 1;
     }
 
-    printf("\nAll processes completed at time %d\n", current_time);
-    // Display CPU utilization
-    calculate_and_display_cpu_utilization(gantt, *gantt_size);
+    return 0;
 }
-/*
- * NON-PREEMPTIVE ALGORITHM 2
- * ---------------------------
- * TODO: Implement ANOTHER non-preemptive algorithm (different from above)
- *
- * Remember to:
- *   1. Handle idle time when no process is available
- *   2. Update the Gantt chart array
- *   3. Set completion_time for each process
- */
-void non_preemptive_algorithm_2(Process processes[], int n, GanttBlock gantt[], int *gantt_size)
+
+void process_reader_close(ProcessReader *reader)
+{
+    if (reader->bad_lines > 0)
+        fprintf(stderr, "Warning: %d malformed line(s) skipped in '%s'%s\n", reader->bad_lines, reader->filename,
+                reader->bad_lines > MAX_REPORTED_BAD_LINES ? " (only the first few are listed)" : "");
+    if (reader->file != NULL)
+        fclose(reader->file);
+    free(reader->buffer);
+    reader->file = NULL;
+    reader->buffer = NULL;
+}
+
+// Load every process in the file into the table (previous contents are replaced)
+// Binary traces are detected by their magic; anything else is parsed as CSV.
+// Expected CSV format per line: PID, Arrival_Time, Burst_Time[, Priority]
+// Returns the number of processes loaded, or -1 on error
+int read_processes_from_file(const char *filename, ProcessTable *table)
 {
-    /*
-     * SHORTEST JOB FIRST (SJF) - Non-Preemptive
-     * ==========================================
-     * Selection Criteria: Process with the smallest burst_time
-     * Tie-breaker: If burst times are equal, use arrival_time (FCFS)
-     *
-     * Characteristics:
-     * - Optimal for minimizing average waiting time
-     * - Non-preemptive: once a process starts, it runs to completion
-     * - May cause starvation for longer processes if short ones keep arriving
-     */
+    table->count = 0;
 
-    int current_time = 0;
-    int completed = 0;
-    *gantt_size = 0;
+    if (is_binary_trace_file(filename))
+        return read_processes_from_binary(filename, table);
 
-    printf("\n===== SHORTEST JOB FIRST (SJF) - Non-Preemptive =====\n");
+    ProcessReader reader;
+    if (process_reader_open(&reader, filename) != 0)
+        return -1;
+
+    // Size the table from the input once, then fill it in a single pass
+    int line_count = count_lines_in_file(reader.file, reader.buffer, reader.buffer_size);
+    rewind(reader.file);
 
-    while (completed < n)
+    if (reserve_process_table(table, line_count > 0 ? line_count : INITIAL_TABLE_CAPACITY) != 0)
     {
-        int selected = -1;
-        int shortest_burst = 999999;
+        process_reader_close(&reader);
+        return -1;
+    }
 
-        // Find process with shortest burst time among those that have arrived
-        for (int i = 0; i < n; i++)
+    int count = 0;
+    while (count < table->capacity && process_reader_next(&reader, &table->items[count]))
+        count++;
+
+    process_reader_close(&reader);
+    table->count = count;
+    return count;
+}
+
+// --- Binary Traces ---
+
+static int binary_header_is_valid(const BinaryTraceHeader *header)
+{
+    return memcmp(header->magic, BINARY_TRACE_MAGIC, sizeof(header->magic)) == 0;
+}
+
+// Check whether a file starts with the binary trace magic
+int is_binary_trace_file(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+        return 0;
+
+    BinaryTraceHeader header;
+    int is_binary = fread(&header, sizeof(header), 1, file) == 1 && binary_header_is_valid(&header);
+    fclose(file);
+    return is_binary;
+}
+
+// Map a file read-only (sequential access is hinted to the OS)
+// Returns 0 on success, -1 if it could not be opened or mapped
+int map_file(const char *filename, MappedFile *map)
+{
+    map->data = NULL;
+    map->size = 0;
+#ifdef _WIN32
+    map->mapping = NULL;
+    map->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+    if (map->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(map->file, &size))
+    {
+        if (map->file != INVALID_HANDLE_VALUE)
+            CloseHandle(map->file);
+        return -1;
+    }
+    map->size = (size_t)size.QuadPart;
+    if (map->size == 0)
+        return 0;
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map->mapping != NULL)
+        map->data = (const unsigned char *)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (map->data == NULL)
+    {
+        unmap_file(map);
+        return -1;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    map->size = (size_t)info.st_size;
+    if (map->size > 0)
+    {
+        void *data = mmap(NULL, map->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED)
         {
-            if (!processes[i].completed && processes[i].arrival_time <= current_time)
-            {
-                // Select if burst time is shorter
-                if (processes[i].burst_time < shortest_burst)
-                {
-                    shortest_burst = processes[i].burst_time;
-                    selected = i;
-                }
-                // Tie-breaker: same burst time -> pick earlier arrival (FCFS)
-                else if (processes[i].burst_time == shortest_burst && selected != -1)
-                {
-                    if (processes[i].arrival_time < processes[selected].arrival_time)
-                    {
-                        selected = i;
-                    }
-                }
-            }
+            posix_madvise(data, map->size, POSIX_MADV_SEQUENTIAL);
+            map->data = (const unsigned char *)data;
+        }
+    }
+    close(fd); // The mapping keeps the file open
+    if (map->size > 0 && map->data == NULL)
+        return -1;
+#endif
+    return 0;
+}
+
+void unmap_file(MappedFile *map)
+{
+#ifdef _WIN32
+    if (map->data != NULL)
+        UnmapViewOfFile(map->data);
+    if (map->mapping != NULL)
+        CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#else
+    if (map->data != NULL)
+        munmap((void *)map->data, map->size);
+#endif
+    map->data = NULL;
+    map->size = 0;
+}
+
+// Load a binary trace into the table in one sized allocation, decoding the
+// records straight out of a mapping of the file
+// Returns the number of processes loaded, or -1 on error
+int read_processes_from_binary(const char *filename, ProcessTable *table)
+{
+    table->count = 0;
+
+    MappedFile map;
+    if (map_file(filename, &map) != 0)
+    {
+        printf("Error: Could not open file '%s'\n", filename);
+        return -1;
+    }
+
+    BinaryTraceHeader header;
+    if (map.size < sizeof(header) || (memcpy(&header, map.data, sizeof(header)), !binary_header_is_valid(&header)))
+    {
+        printf("Error: '%s' is not a binary process trace\n", filename);
+        unmap_file(&map);
+        return -1;
+    }
+    size_t record_size = header.version == 1 ? sizeof(BinaryProcessRecordV1) : sizeof(BinaryProcessRecord);
+    if ((header.version != 1 && header.version != BINARY_TRACE_VERSION) || header.record_size != record_size ||
+        (header.field_mask & BINARY_FIELDS_REQUIRED) != BINARY_FIELDS_REQUIRED)
+    {
+        printf("Error: '%s' uses unsupported trace version %u (record size %u, fields 0x%x)\n",
+               filename, header.version, header.record_size, header.field_mask);
+        unmap_file(&map);
+        return -1;
+    }
+    if (header.count > (uint64_t)INT32_MAX)
+    {
+        printf("Error: '%s' holds too many processes (%llu)\n", filename, (unsigned long long)header.count);
+        unmap_file(&map);
+        return -1;
+    }
+
+    int total = (int)header.count;
+    if (reserve_process_table(table, total > 0 ? total : INITIAL_TABLE_CAPACITY) != 0)
+    {
+        unmap_file(&map);
+        return -1;
+    }
+
+    int count = total;
+    size_t present = (map.size - sizeof(header)) / record_size;
+    if (present < (size_t)total)
+    {
+        count = (int)present;
+        fprintf(stderr, "Warning: '%s' is truncated: header says %d processes, found %d\n",
+                filename, total, count);
+    }
+
+    const unsigned char *records = map.data + sizeof(header);
+    for (int i = 0; i < count; i++)
+    {
+        BinaryProcessRecord record;
+        if (header.version == 1)
+        {
+            BinaryProcessRecordV1 old;
+            memcpy(&old, records + (size_t)i * record_size, sizeof(old));
+            record.pid = old.pid;
+            record.priority = old.priority;
+            record.arrival_time = old.arrival_time;
+            record.burst_time = old.burst_time;
+        }
+        else
+            memcpy(&record, records + (size_t)i * record_size, sizeof(record));
+        int priority = (header.field_mask & BINARY_FIELD_PRIORITY) ? record.priority : 0;
+        init_process(&table->items[i], record.pid, record.arrival_time, record.burst_time, priority);
+    }
+
+    unmap_file(&map);
+    table->count = count;
+    return count;
+}
+
+static int write_binary_header(FILE *file, uint32_t field_mask, uint64_t count)
+{
+    BinaryTraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic));
+    header.version = BINARY_TRACE_VERSION;
+    header.field_mask = field_mask | BINARY_FIELDS_REQUIRED;
+    header.count = count;
+    header.record_size = sizeof(BinaryProcessRecord);
+    return fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+}
+
+static void fill_binary_record(BinaryProcessRecord *record, const Process *p)
+{
+    record->pid = p->pid;
+    record->arrival_time = p->arrival_time;
+    record->burst_time = p->burst_time;
+    record->priority = p->priority;
+}
+
+// Write processes as a binary trace
+// Returns 0 on success, -1 on error
+int write_processes_binary(const char *filename, const Process processes[], int n, uint32_t field_mask)
+{
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", filename);
+        return -1;
+    }
+
+    int ok = write_binary_header(file, field_mask, (uint64_t)n) == 0;
+    BinaryProcessRecord record;
+    for (int i = 0; ok && i < n; i++)
+    {
+        fill_binary_record(&record, &processes[i]);
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+
+    if (fclose(file) != 0 || !ok)
+    {
+        printf("Error: Could not write '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// Stream a PID,Arrival,Burst[,Priority] CSV into a binary trace without loading it all
+// Returns the number of processes written, or -1 on error
+int convert_csv_to_binary(const char *csv_filename, const char *binary_filename)
+{
+    ProcessReader reader;
+    if (process_reader_open(&reader, csv_filename) != 0)
+        return -1;
+
+    FILE *out = fopen(binary_filename, "wb");
+    BinaryProcessRecord *block = (BinaryProcessRecord *)malloc(BINARY_RECORDS_PER_BLOCK * sizeof(BinaryProcessRecord));
+    if (out == NULL || block == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", binary_filename);
+        if (out != NULL)
+            fclose(out);
+        free(block);
+        process_reader_close(&reader);
+        return -1;
+    }
+
+    // Placeholder header; the count and field mask are patched in at the end
+    int ok = write_binary_header(out, 0, 0) == 0;
+    uint32_t field_mask = BINARY_FIELDS_REQUIRED;
+    uint64_t count = 0;
+    int buffered = 0;
+    Process p;
+
+    while (ok && process_reader_next(&reader, &p))
+    {
+        if (reader.last_fields == 4)
+            field_mask |= BINARY_FIELD_PRIORITY;
+        fill_binary_record(&block[buffered++], &p);
+        count++;
+        if (buffered == BINARY_RECORDS_PER_BLOCK)
+        {
+            ok = fwrite(block, sizeof(BinaryProcessRecord), (size_t)buffered, out) == (size_t)buffered;
+            buffered = 0;
+        }
+    }
+    if (ok && buffered > 0)
+        ok = fwrite(block, sizeof(BinaryProcessRecord), (size_t)buffered, out) == (size_t)buffered;
+    if (ok && count > (uint64_t)INT32_MAX)
+        ok = 0;
+    if (ok)
+        ok = fseek(out, 0, SEEK_SET) == 0 && write_binary_header(out, field_mask, count) == 0;
+
+    free(block);
+    process_reader_close(&reader);
+    if (fclose(out) != 0 || !ok)
+    {
+        printf("Error: Could not write '%s'\n", binary_filename);
+        return -1;
+    }
+    return (int)count;
+}
+
+// Write processes as PID,Arrival_Time,Burst_Time,Priority lines (the input format)
+int write_processes_csv(const char *filename, const Process processes[], int n)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", filename);
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, READ_BLOCK_SIZE);
+
+    int ok = 1;
+    for (int i = 0; ok && i < n; i++)
+        ok = fprintf(file, "%d,%lld,%lld,%d\n", processes[i].pid, processes[i].arrival_time,
+                     processes[i].burst_time, processes[i].priority) > 0;
+
+    if (fclose(file) != 0 || !ok)
+    {
+        printf("Error: Could not write '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// --- Utility Functions ---
+
+// Reset all calculated fields (use before running an algorithm)
+void reset_processes(Process processes[], int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        processes[i].remaining_time = processes[i].burst_time;
+        processes[i].completion_time = 0;
+        // Kept consistent with completion_time; the engines overwrite both when
+        // the process completes
+        processes[i].turnaround_time = -processes[i].arrival_time;
+        processes[i].waiting_time = processes[i].turnaround_time - processes[i].burst_time;
+        processes[i].started = 0;
+        processes[i].first_run_time = 0;
+        processes[i].completed = 0;
+    }
+}
+
+// Copy process array (to preserve original data)
+void copy_processes(Process source[], Process dest[], int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        dest[i] = source[i];
+    }
+}
+
+// Fold a 64-bit value into an FNV-1a hash byte by byte, low byte first, so the
+// hash is the same on every platform
+static uint64_t fnv1a_add(uint64_t hash, uint64_t value)
+{
+    for (int byte = 0; byte < 8; byte++)
+    {
+        hash ^= (value >> (8 * byte)) & 0xffu;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// FNV-1a digest of the input fields (pid, arrival, burst, priority) of a table, in table order
+uint64_t process_table_digest(const Process processes[], int n)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (int i = 0; i < n; i++)
+    {
+        hash = fnv1a_add(hash, (uint64_t)processes[i].pid);
+        hash = fnv1a_add(hash, (uint64_t)processes[i].arrival_time);
+        hash = fnv1a_add(hash, (uint64_t)processes[i].burst_time);
+        hash = fnv1a_add(hash, (uint64_t)processes[i].priority);
+    }
+    return hash;
+}
+
+// Sort key paired with the process's current position (positions break ties,
+// which keeps every sort stable like the original bubble sorts)
+typedef struct
+{
+    SimTime key;
+    int index;
+} SortKey;
+
+// Stable bottom-up merge sort of keys[0..n); scratch must hold n entries
+static void merge_sort_keys(SortKey keys[], SortKey scratch[], int n)
+{
+    SortKey *src = keys;
+    SortKey *dst = scratch;
+
+    for (int width = 1; width < n; width *= 2)
+    {
+        for (int lo = 0; lo < n; lo += 2 * width)
+        {
+            int mid = lo + width < n ? lo + width : n;
+            int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            int i = lo, j = mid, k = lo;
+
+            while (i < mid && j < hi)
+                dst[k++] = (src[j].key < src[i].key) ? src[j++] : src[i++];
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
         }
+        SortKey *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != keys)
+        memcpy(keys, src, (size_t)n * sizeof(SortKey));
+}
+
+// Reorder processes by keys[i].key (ascending, stable). Only the 16-byte
+// SortKeys (key and position) move during sorting; each Process is copied once
+// when the order is applied.
+// Takes ownership of keys.
+static void sort_processes_by_keys(Process processes[], int n, SortKey keys[])
+{
+    // Already in order (the common case on reload): nothing to move
+    int sorted = 1;
+    for (int i = 1; i < n && sorted; i++)
+        sorted = keys[i - 1].key <= keys[i].key;
 
-        if (selected == -1)
+    SortKey *scratch = sorted ? NULL : (SortKey *)malloc((size_t)n * sizeof(SortKey));
+    Process *ordered = sorted ? NULL : (Process *)malloc((size_t)n * sizeof(Process));
+
+    if (!sorted && scratch != NULL && ordered != NULL)
+    {
+        merge_sort_keys(keys, scratch, n);
+        for (int i = 0; i < n; i++)
+            ordered[i] = processes[keys[i].index];
+        memcpy(processes, ordered, (size_t)n * sizeof(Process));
+    }
+    else if (!sorted)
+    {
+        // Out of memory: stable in-place insertion sort on the keys themselves
+        for (int i = 1; i < n; i++)
         {
-            // No process available - CPU is idle
-            // Find the next process to arrive
-            int next_arrival = 999999;
-            for (int i = 0; i < n; i++)
+            Process current = processes[i];
+            SimTime key = keys[i].key;
+            int j = i - 1;
+            while (j >= 0 && keys[j].key > key)
             {
-                if (!processes[i].completed && processes[i].arrival_time > current_time)
-                {
-                    if (processes[i].arrival_time < next_arrival)
-                    {
-                        next_arrival = processes[i].arrival_time;
-                    }
-                }
+                processes[j + 1] = processes[j];
+                keys[j + 1] = keys[j];
+                j--;
             }
+            processes[j + 1] = current;
+            keys[j + 1].key = key;
+        }
+    }
+
+    free(scratch);
+    free(ordered);
+    free(keys);
+}
+
+// Sort field of a process
+typedef SimTime (*ProcessSortField)(const Process *p);
+
+static SimTime arrival_field(const Process *p)
+{
+    return p->arrival_time;
+}
+
+static SimTime burst_field(const Process *p)
+{
+    return p->burst_time;
+}
+
+static SimTime priority_field(const Process *p)
+{
+    return p->priority;
+}
+
+// Sort processes by field (ascending, stable). If the key array can't be
+// allocated, falls back to a stable in-place insertion sort on the processes.
+static void sort_processes_by(Process processes[], int n, ProcessSortField field)
+{
+    if (n < 2)
+        return;
 
-            if (next_arrival != 999999)
+    SortKey *keys = (SortKey *)malloc((size_t)n * sizeof(SortKey));
+    if (keys == NULL)
+    {
+        for (int i = 1; i < n; i++)
+        {
+            Process current = processes[i];
+            SimTime key = field(&current);
+            int j = i - 1;
+            while (j >= 0 && field(&processes[j]) > key)
             {
-                // Add IDLE block to Gantt chart
-                gantt[*gantt_size].pid = -1;
-                gantt[*gantt_size].start_time = current_time;
-                gantt[*gantt_size].end_time = next_arrival;
-                (*gantt_size)++;
-
-                printf("[IDLE] Time %d -> %d (waiting for next arrival)\n",
-                       current_time, next_arrival);
-                current_time = next_arrival;
+                processes[j + 1] = processes[j];
+                j--;
             }
+            processes[j + 1] = current;
         }
-        else
-        {
-            // Execute the selected process to completion (non-preemptive)
-            Process *p = &processes[selected];
+        return;
+    }
 
-            int wait_time = current_time - p->arrival_time;
-            printf("[P%d] Start: %d | Arrival: %d | Waited: %d | Burst: %d (shortest available)\n",
-                   p->pid, current_time, p->arrival_time, wait_time, p->burst_time);
+    for (int i = 0; i < n; i++)
+    {
+        keys[i].key = field(&processes[i]);
+        keys[i].index = i;
+    }
+    sort_processes_by_keys(processes, n, keys);
+}
 
-            // Add to Gantt chart
-            gantt[*gantt_size].pid = p->pid;
-            gantt[*gantt_size].start_time = current_time;
-            gantt[*gantt_size].end_time = current_time + p->burst_time;
-            (*gantt_size)++;
+// Sort by arrival time (ascending, stable)
+void sort_by_arrival(Process processes[], int n)
+{
+    sort_processes_by(processes, n, arrival_field);
+}
 
-            // Update time and mark process as completed
-            current_time += p->burst_time;
-            p->completion_time = current_time;
-            p->completed = 1;
-            completed++;
+// Sort by burst time (ascending, stable) - for SJF
+void sort_by_burst(Process processes[], int n)
+{
+    sort_processes_by(processes, n, burst_field);
+}
 
-            printf("     Completed at time %d\n", current_time);
-        }
+// Sort by priority (ascending, stable - lower number = higher priority)
+void sort_by_priority(Process processes[], int n)
+{
+    sort_processes_by(processes, n, priority_field);
+}
+
+// --- Gantt Sinks ---
+
+// Hand a finished block to the sink: update the totals, then the backend
+void gantt_sink_emit(GanttSink *sink, const GanttBlock *block)
+{
+    // Multi-CPU runs report lanes out of time order, so track the extremes
+    if (sink->blocks == 0 || block->start_time < sink->first_start)
+        sink->first_start = block->start_time;
+    if (sink->blocks == 0 || block->end_time > sink->last_end)
+        sink->last_end = block->end_time;
+    sink->blocks++;
+
+    if (block->pid == -1)
+        sink->idle_time += block->end_time - block->start_time;
+    else if (block->pid == GANTT_SWITCH)
+        sink->switch_time += block->end_time - block->start_time;
+    else
+        sink->busy_time += block->end_time - block->start_time;
+
+    if (sink->write != NULL)
+        sink->write(sink, block);
+}
+
+// A CPU (core) dispatched a different process than it ran last. Counted
+// here rather than from GANTT_SWITCH blocks, so free switches count too.
+void gantt_sink_count_switch(GanttSink *sink, int core)
+{
+    sink->switches++;
+    if (sink->lanes != NULL)
+        gantt_sink_count_switch(&sink->lanes[core], core);
+}
+
+// Totals only: constant memory however long the run is
+void gantt_sink_init_summary(GanttSink *sink)
+{
+    memset(sink, 0, sizeof(*sink));
+}
+
+static void gantt_buffer_write(GanttSink *sink, const GanttBlock *block)
+{
+    GanttBuffer *buffer = (GanttBuffer *)sink->context;
+    if (buffer->size == buffer->capacity)
+    {
+        int grown = buffer->capacity > 0 ? buffer->capacity * 2 : 64;
+        buffer->blocks = (GanttBlock *)checked_realloc(buffer->blocks, (size_t)grown * sizeof(GanttBlock));
+        buffer->capacity = grown;
     }
+    buffer->blocks[buffer->size++] = *block;
+}
 
-    printf("\nAll processes completed at time %d\n", current_time);
-    // Display CPU utilization
-    calculate_and_display_cpu_utilization(gantt, *gantt_size);
+// Keep every block in a growable array (for display_gantt_chart)
+void gantt_sink_init_buffer(GanttSink *sink, GanttBuffer *buffer)
+{
+    gantt_sink_init_summary(sink);
+    buffer->blocks = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    sink->write = gantt_buffer_write;
+    sink->context = buffer;
+}
+
+void gantt_buffer_free(GanttBuffer *buffer)
+{
+    free(buffer->blocks);
+    buffer->blocks = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+static void gantt_file_write(GanttSink *sink, const GanttBlock *block)
+{
+    fprintf((FILE *)sink->context, "%d,%lld,%lld\n", block->pid, block->start_time, block->end_time);
+}
+
+// Write each block straight to a CSV file (PID,Start,End; PID -1 = idle, -2 = context switch)
+void gantt_sink_init_file(GanttSink *sink, FILE *file)
+{
+    gantt_sink_init_summary(sink);
+    sink->write = gantt_file_write;
+    sink->context = file;
+    fprintf(file, "PID,Start,End\n");
+}
+
+static void gantt_lanes_write(GanttSink *sink, const GanttBlock *block)
+{
+    GanttSink *lanes = (GanttSink *)sink->context;
+    gantt_sink_emit(&lanes[block->core], block);
+}
+
+// Route each block to lanes[block->core] (one sink per CPU, set up by the
+// caller with any backend); this sink keeps the totals over all CPUs
+void gantt_sink_init_lanes(GanttSink *sink, GanttSink lanes[])
+{
+    gantt_sink_init_summary(sink);
+    sink->write = gantt_lanes_write;
+    sink->context = lanes;
+    sink->lanes = lanes;
+}
+
+// --- Calculation & Display ---
+
+// Time from arrival to the first dispatch (processes that never ran, such as
+// zero-length bursts, respond when they complete)
+static SimTime response_time(const Process *p)
+{
+    return (p->started ? p->first_run_time : p->completion_time) - p->arrival_time;
+}
+
+static double bounded_slowdown(SimTime turnaround, SimTime burst)
+{
+    double slowdown = (double)turnaround / (double)(burst > SLOWDOWN_BOUND ? burst : SLOWDOWN_BOUND);
+    return slowdown > 1.0 ? slowdown : 1.0;
+}
+
+// 0-based nearest-rank index of the percent-th percentile of n samples
+static long long percentile_rank(long long n, int percent)
+{
+    long long rank = (n * percent + 99) / 100;
+    return rank > 0 ? rank - 1 : 0;
+}
+
+// Partially sort values so that values[k] is the k-th smallest, everything
+// before it is <= it and everything after is >= it (quickselect, O(n) expected)
+static SimTime select_kth(SimTime values[], int n, int k)
+{
+    int left = 0, right = n - 1;
+    while (left < right)
+    {
+        // Median of three keeps sorted input (the common case here) linear
+        int mid = left + (right - left) / 2;
+        SimTime a = values[left], b = values[mid], c = values[right];
+        SimTime pivot = (a < b) ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+        int i = left, j = right;
+        while (i <= j)
+        {
+            while (values[i] < pivot)
+                i++;
+            while (values[j] > pivot)
+                j--;
+            if (i <= j)
+            {
+                SimTime swap = values[i];
+                values[i++] = values[j];
+                values[j--] = swap;
+            }
+        }
+        if (k <= j)
+            right = j;
+        else if (k >= i)
+            left = i;
+        else
+            break; // values[j + 1 .. i - 1] all equal the pivot
+    }
+    return values[k];
+}
+
+// Fill stats from n samples (reordered in place); total is their exact sum
+static void latency_stats_exact(SimTime values[], int n, long long total, LatencyStats *stats)
+{
+    // Each selection leaves the smaller values in front, so the next, lower
+    // percentile only has to search that prefix
+    long long k99 = percentile_rank(n, 99);
+    long long k95 = percentile_rank(n, 95);
+    long long k50 = percentile_rank(n, 50);
+    SimTime max = values[0];
+    for (int i = 1; i < n; i++)
+        if (values[i] > max)
+            max = values[i];
+
+    stats->mean = (double)total / n;
+    stats->max = max;
+    stats->p99 = select_kth(values, n, (int)k99);
+    stats->p95 = select_kth(values, (int)k99 + 1, (int)k95);
+    stats->p50 = select_kth(values, (int)k95 + 1, (int)k50);
+}
+
+// Exact metrics over a finished table in one read-only pass (turnaround_time
+// and waiting_time are filled in by the engines). Returns 0, or -1 if out of memory.
+int compute_schedule_metrics(const Process processes[], int n, ScheduleMetrics *metrics)
+{
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->processes = n;
+    if (n <= 0)
+        return 0;
+
+    double since = STAT_CLOCK();
+    SimTime *waiting = (SimTime *)malloc((size_t)n * 3 * sizeof(SimTime));
+    if (waiting == NULL)
+    {
+        printf("Error: Could not allocate metrics storage for %d processes\n", n);
+        return -1;
+    }
+    SimTime *turnaround = waiting + n;
+    SimTime *response = turnaround + n;
+
+    long long total_waiting = 0, total_turnaround = 0, total_response = 0;
+    double slowdown_total = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        const Process *p = &processes[i];
+        double slowdown = bounded_slowdown(p->turnaround_time, p->burst_time);
+        slowdown_total += slowdown;
+        if (slowdown > metrics->max_slowdown)
+            metrics->max_slowdown = slowdown;
+        waiting[i] = p->waiting_time;
+        turnaround[i] = p->turnaround_time;
+        response[i] = response_time(p);
+        total_waiting += waiting[i];
+        total_turnaround += turnaround[i];
+        total_response += response[i];
+    }
+    metrics->avg_slowdown = slowdown_total / n;
+    latency_stats_exact(waiting, n, total_waiting, &metrics->waiting);
+    latency_stats_exact(turnaround, n, total_turnaround, &metrics->turnaround);
+    latency_stats_exact(response, n, total_response, &metrics->response);
+
+    free(waiting);
+    STAT_PHASE(PHASE_METRICS, since);
+    return 0;
+}
+
+// Index of the highest set bit (bits must be non-zero)
+static int highest_set_bit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(bits);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return (int)index;
+#else
+    int index = 0;
+    while (bits >>= 1)
+        index++;
+    return index;
+#endif
+}
+
+// Bucket of a value: itself below LATENCY_EXACT_LIMIT, then the top five bits
+static int latency_bucket(SimTime value)
+{
+    if (value < LATENCY_EXACT_LIMIT)
+        return value < 0 ? 0 : (int)value;
+    int exponent = highest_set_bit((uint64_t)value); // >= 5
+    return LATENCY_EXACT_LIMIT + (exponent - 5) * LATENCY_SUB_BUCKETS +
+           (int)(((uint64_t)value >> (exponent - 4)) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+// Largest value that falls into bucket (percentiles round up, never down)
+static SimTime latency_bucket_limit(int bucket)
+{
+    if (bucket < LATENCY_EXACT_LIMIT)
+        return bucket;
+    int exponent = (bucket - LATENCY_EXACT_LIMIT) / LATENCY_SUB_BUCKETS + 5;
+    int sub = (bucket - LATENCY_EXACT_LIMIT) % LATENCY_SUB_BUCKETS;
+    SimTime low = (SimTime)(LATENCY_SUB_BUCKETS + sub) << (exponent - 4);
+    return low + ((SimTime)1 << (exponent - 4)) - 1;
+}
+
+static void latency_histogram_add(LatencyHistogram *histogram, SimTime value)
+{
+    histogram->counts[latency_bucket(value)]++;
+    if (histogram->samples == 0 || value > histogram->max)
+        histogram->max = value;
+    histogram->samples++;
+    histogram->total += value;
+}
+
+static SimTime latency_histogram_percentile(const LatencyHistogram *histogram, int percent)
+{
+    long long rank = percentile_rank(histogram->samples, percent);
+    long long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++)
+    {
+        seen += histogram->counts[b];
+        if (seen > rank)
+        {
+            SimTime limit = latency_bucket_limit(b);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+static void latency_stats_from_histogram(const LatencyHistogram *histogram, LatencyStats *stats)
+{
+    if (histogram->samples == 0)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    stats->mean = (double)histogram->total / histogram->samples;
+    stats->p50 = latency_histogram_percentile(histogram, 50);
+    stats->p95 = latency_histogram_percentile(histogram, 95);
+    stats->p99 = latency_histogram_percentile(histogram, 99);
+    stats->max = histogram->max;
+}
+
+void metrics_accumulator_init(MetricsAccumulator *accumulator)
+{
+    memset(accumulator, 0, sizeof(*accumulator));
+}
+
+// Add one completed process (as reported by an engine, so its turnaround and
+// waiting time are set)
+void metrics_accumulator_add(MetricsAccumulator *accumulator, const Process *process)
+{
+    double slowdown = bounded_slowdown(process->turnaround_time, process->burst_time);
+
+    latency_histogram_add(&accumulator->waiting, process->waiting_time);
+    latency_histogram_add(&accumulator->turnaround, process->turnaround_time);
+    latency_histogram_add(&accumulator->response, response_time(process));
+    accumulator->slowdown_total += slowdown;
+    if (slowdown > accumulator->slowdown_max)
+        accumulator->slowdown_max = slowdown;
+}
+
+void metrics_accumulator_finish(const MetricsAccumulator *accumulator, ScheduleMetrics *metrics)
+{
+    long long n = accumulator->turnaround.samples;
+    metrics->processes = (int)n;
+    latency_stats_from_histogram(&accumulator->waiting, &metrics->waiting);
+    latency_stats_from_histogram(&accumulator->turnaround, &metrics->turnaround);
+    latency_stats_from_histogram(&accumulator->response, &metrics->response);
+    metrics->avg_slowdown = n > 0 ? accumulator->slowdown_total / n : 0.0;
+    metrics->max_slowdown = accumulator->slowdown_max;
+}
+
+// Mean and tail of waiting, turnaround and response time, plus slowdown
+void display_latency_metrics(const ScheduleMetrics *metrics)
+{
+    const LatencyStats *rows[] = {&metrics->waiting, &metrics->turnaround, &metrics->response};
+    const char *names[] = {"Waiting", "Turnaround", "Response"};
+
+    printf("\n+------------+------------+----------+----------+----------+----------+\n");
+    printf("| Latency    |       Mean |      p50 |      p95 |      p99 |      Max |\n");
+    printf("+------------+------------+----------+----------+----------+----------+\n");
+    for (int i = 0; i < 3; i++)
+        printf("| %-10s | %10.2f | %8lld | %8lld | %8lld | %8lld |\n", names[i], rows[i]->mean, rows[i]->p50,
+               rows[i]->p95, rows[i]->p99, rows[i]->max);
+    printf("+------------+------------+----------+----------+----------+----------+\n");
+    printf("Bounded Slowdown (bursts under %d count as %d): avg %.2f, max %.2f\n", SLOWDOWN_BOUND,
+           SLOWDOWN_BOUND, metrics->avg_slowdown, metrics->max_slowdown);
+}
+
+// Instrumentation counters and phase times (see --stats); load and sort are
+// shared by every algorithm of a batch run
+void display_engine_stats(const EngineStats *stats)
+{
+    const double *t = stats->seconds;
+    printf("\n===== ENGINE STATS =====\n");
+    printf("Dispatches: %lld\n", stats->dispatches);
+    printf("Queue Operations: %lld\n", stats->queue_ops);
+    printf("Selections: %lld (%.2f candidates each)\n", stats->selections,
+           stats->selections > 0 ? (double)stats->candidates / (double)stats->selections : 0.0);
+    printf("Idle Jumps: %lld\n", stats->idle_jumps);
+    printf("Gantt Merges: %lld\n", stats->gantt_merges);
+    printf("Seconds: load %.6f, sort %.6f, schedule %.6f, metrics %.6f, render %.6f\n", t[PHASE_LOAD],
+           t[PHASE_SORT], t[PHASE_SCHEDULE], t[PHASE_METRICS], t[PHASE_RENDER]);
+}
+
+// Display process table with results
+void display_results(const Process processes[], int n)
+{
+    printf("\n");
+    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
+    printf("| PID |  Arrival | Burst | Priority | Completion | Turnaround |  Waiting |\n");
+    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
+
+    for (int i = 0; i < n; i++)
+    {
+        printf("| %3d | %8lld | %5lld | %8d | %10lld | %10lld | %8lld |\n",
+               processes[i].pid,
+               processes[i].arrival_time,
+               processes[i].burst_time,
+               processes[i].priority,
+               processes[i].completion_time,
+               processes[i].turnaround_time,
+               processes[i].waiting_time);
+    }
+
+    printf("+-----+----------+-------+----------+------------+------------+----------+\n");
+
+    // One pass gives the averages and the latency tail
+    ScheduleMetrics metrics;
+    if (compute_schedule_metrics(processes, n, &metrics) == 0)
+    {
+        printf("\nAverage Waiting Time: %.2f\n", metrics.waiting.mean);
+        printf("Average Turnaround Time: %.2f\n", metrics.turnaround.mean);
+        printf("Average Response Time: %.2f\n", metrics.response.mean);
+        display_latency_metrics(&metrics);
+    }
+}
+
+// Characters a block takes in the chart: two per time unit, at least four
+static int gantt_chart_width(const GanttBlock *block)
+{
+    SimTime width = (block->end_time - block->start_time) * 2;
+    if (width < 4)
+        return 4;
+    return width < INT32_MAX ? (int)width : INT32_MAX;
+}
+
+// Fold a timeline into at most `columns` equal time buckets. Adjacent blocks of
+// one process count as one block. A bucket shows the block covering at least
+// half of it, or else idle if it is mostly idle and GANTT_MIXED if not; runs
+// of buckets that show the same pid merge into one segment.
+// segments[] needs room for `columns`; segment times are bucket edges.
+// Returns the number of segments and sets *step to the bucket length, or -1
+// if out of memory
+static int gantt_scale(const GanttBlock gantt[], int gantt_size, int columns, GanttBlock segments[], SimTime *step)
+{
+    SimTime first = gantt[0].start_time;
+    SimTime last = gantt[gantt_size - 1].end_time;
+    SimTime span = last - first;
+    SimTime bucket = span > columns ? (span + columns - 1) / columns : 1;
+    int used = span > 0 ? (int)((span + bucket - 1) / bucket) : 1;
+
+    SimTime *cover = (SimTime *)malloc((size_t)used * 2 * sizeof(SimTime));
+    if (cover == NULL)
+        return -1;
+    SimTime *idle = cover + used;
+    for (int c = 0; c < used; c++)
+    {
+        segments[c].pid = -1;
+        cover[c] = -1;
+        idle[c] = 0;
+    }
+
+    for (int i = 0; i < gantt_size; i++)
+    {
+        int pid = gantt[i].pid;
+        SimTime start = gantt[i].start_time;
+        SimTime end = gantt[i].end_time;
+        while (i + 1 < gantt_size && gantt[i + 1].pid == pid && gantt[i + 1].start_time == end)
+            end = gantt[++i].end_time;
+
+        int c = (int)((start - first) / bucket);
+        int c_last = end > start ? (int)((end - 1 - first) / bucket) : c;
+        if (c_last >= used)
+            c_last = used - 1;
+        for (; c <= c_last; c++)
+        {
+            SimTime bucket_start = first + c * bucket;
+            SimTime bucket_end = bucket_start + bucket < last ? bucket_start + bucket : last;
+            SimTime overlap = (end < bucket_end ? end : bucket_end) - (start > bucket_start ? start : bucket_start);
+            if (pid == -1)
+                idle[c] += overlap;
+            if (overlap > cover[c])
+            {
+                cover[c] = overlap;
+                segments[c].pid = pid;
+            }
+        }
+    }
+    for (int c = 0; c < used; c++)
+    {
+        SimTime length = (c + 1 < used ? first + (c + 1) * bucket : last) - (first + c * bucket);
+        if (cover[c] * 2 < length)
+            segments[c].pid = idle[c] * 2 >= length ? -1 : GANTT_MIXED;
+    }
+    free(cover);
+
+    int count = 0;
+    for (int c = 0; c < used; c++)
+    {
+        SimTime bucket_end = first + (c + 1) * bucket < last ? first + (c + 1) * bucket : last;
+        if (count > 0 && segments[count - 1].pid == segments[c].pid)
+        {
+            segments[count - 1].end_time = bucket_end;
+            continue;
+        }
+        segments[count].pid = segments[c].pid;
+        segments[count].core = gantt[0].core;
+        segments[count].start_time = first + c * bucket;
+        segments[count].end_time = bucket_end;
+        count++;
+    }
+
+    *step = bucket;
+    return count;
+}
+
+// Text chart of a timeline too long for two characters per time unit: one
+// column per bucket of gantt_scale, so a segment of k buckets takes k - 1
+// characters plus its '|'. Shared time and processes too narrow for their
+// label show as '#', idle time and context switches too narrow as blanks.
+// Time markers are bucket edges, left out where they would run into the
+// previous one or into the end time, which is always shown.
+static void display_scaled_gantt_chart(const GanttBlock gantt[], int gantt_size)
+{
+    GanttBlock segments[GANTT_CHART_COLUMNS];
+    SimTime step;
+    int count = gantt_scale(gantt, gantt_size, GANTT_CHART_COLUMNS, segments, &step);
+    if (count < 0)
+    {
+        printf("\nError: Could not allocate the Gantt chart.\n");
+        return;
+    }
+
+    // The last segment takes the rest of the chart (at least one column), so a
+    // short final bucket can't collapse onto the previous '|'
+    int widths[GANTT_CHART_COLUMNS];
+    int drawn = 0;
+    for (int i = 0; i + 1 < count; i++)
+    {
+        widths[i] = (int)((segments[i].end_time - segments[i].start_time + step - 1) / step) - 1;
+        drawn += widths[i] + 1;
+    }
+    widths[count - 1] = GANTT_CHART_COLUMNS - drawn - 1 > 1 ? GANTT_CHART_COLUMNS - drawn - 1 : 1;
+
+    printf("\n===== GANTT CHART =====\n");
+    printf("(%d blocks over %lld time units, one column = %lld)\n\n", gantt_size,
+           gantt[gantt_size - 1].end_time - gantt[0].start_time, step);
+
+    // Top border
+    printf(" ");
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < widths[i]; j++)
+            printf("-");
+        printf(" ");
+    }
+    printf("\n|");
+
+    // Process IDs
+    for (int i = 0; i < count; i++)
+    {
+        int width = widths[i];
+        int pid = segments[i].pid;
+        if (pid == -1)
+            printf("%*s|", width, width >= 4 ? "IDLE" : "");
+        else if (pid == GANTT_SWITCH)
+            printf("%*s|", width, width >= 2 ? "CS" : "");
+        else if (pid != GANTT_MIXED && width >= snprintf(NULL, 0, " P%d", pid))
+            printf(" P%-*d|", width - 2, pid);
+        else
+        {
+            for (int j = 0; j < width; j++)
+                printf("#");
+            printf("|");
+        }
+    }
+    printf("\n ");
+
+    // Bottom border
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < widths[i]; j++)
+            printf("-");
+        printf(" ");
+    }
+    printf("\n");
+
+    // Time markers, each ending under its segment's closing '|'. The end of the
+    // timeline is always shown: markers that would run into it are left out.
+    char end_marker[24];
+    int end_start = drawn + widths[count - 1] + 1 -
+                    snprintf(end_marker, sizeof(end_marker), "%lld", segments[count - 1].end_time) + 1;
+    int length = printf("%lld", gantt[0].start_time);
+    int column = 0;
+    for (int i = 0; i + 1 < count; i++)
+    {
+        char marker[24];
+        int marker_length = snprintf(marker, sizeof(marker), "%lld", segments[i].end_time);
+        column += widths[i] + 1;
+        int pad = column - marker_length + 1 - length;
+        if (pad < 1 || column + 1 >= end_start)
+            continue;
+        printf("%*s%s", pad, "", marker);
+        length = column + 1;
+    }
+    printf("%*s%s\n", end_start - length > 1 ? end_start - length : 1, "", end_marker);
+}
+
+// Display Gantt chart (including idle times)
+void display_gantt_chart(GanttBlock gantt[], int gantt_size)
+{
+    if (gantt_size == 0)
+    {
+        printf("\nNo Gantt chart data to display.\n");
+        return;
+    }
+
+    // Two characters per time unit, unless that would flood the terminal
+    long long total_width = 1;
+    for (int i = 0; i < gantt_size && total_width <= GANTT_EXACT_WIDTH; i++)
+        total_width += (long long)gantt_chart_width(&gantt[i]) + 1;
+    if (total_width > GANTT_EXACT_WIDTH)
+    {
+        display_scaled_gantt_chart(gantt, gantt_size);
+        return;
+    }
+
+    printf("\n===== GANTT CHART =====\n\n");
+
+    // Top border
+    printf(" ");
+    for (int i = 0; i < gantt_size; i++)
+    {
+        int width = gantt_chart_width(&gantt[i]);
+        for (int j = 0; j < width; j++)
+            printf("-");
+        printf(" ");
+    }
+    printf("\n|");
+
+    // Process IDs
+    for (int i = 0; i < gantt_size; i++)
+    {
+        int width = gantt_chart_width(&gantt[i]);
+        if (gantt[i].pid == -1)
+        {
+            // Idle time
+            printf("%*s|", width, "IDLE");
+        }
+        else if (gantt[i].pid == GANTT_SWITCH)
+        {
+            // Context switch overhead
+            printf("%*s|", width, "CS");
+        }
+        else
+        {
+            printf(" P%-*d|", width - 2, gantt[i].pid);
+        }
+    }
+    printf("\n ");
+
+    // Bottom border
+    for (int i = 0; i < gantt_size; i++)
+    {
+        int width = gantt_chart_width(&gantt[i]);
+        for (int j = 0; j < width; j++)
+            printf("-");
+        printf(" ");
+    }
+    printf("\n");
+
+    // Time markers
+    printf("%lld", gantt[0].start_time);
+    for (int i = 0; i < gantt_size; i++)
+    {
+        int width = gantt_chart_width(&gantt[i]);
+        printf("%*lld", width + 1, gantt[i].end_time);
+    }
+    printf("\n");
+}
+
+// Draw one CPU lane per chart to an SVG file (an HTML page around it if the
+// name ends in .html). Lanes are folded by gantt_scale to GANTT_SVG_COLUMNS
+// buckets, one pixel each, so even a very long run writes at most that many
+// rectangles per CPU; each one's tooltip gives its pid and time range.
+// Returns 0, or -1 if the file can't be written
+int write_gantt_svg(const char *filename, const GanttBuffer charts[], int lanes)
+{
+    const int left = 60, top = 10, gap = 6;
+    SimTime first = 0, last = 0;
+    int seen = 0;
+    for (int c = 0; c < lanes; c++)
+    {
+        if (charts[c].size == 0)
+            continue;
+        if (!seen || charts[c].blocks[0].start_time < first)
+            first = charts[c].blocks[0].start_time;
+        if (!seen || charts[c].blocks[charts[c].size - 1].end_time > last)
+            last = charts[c].blocks[charts[c].size - 1].end_time;
+        seen = 1;
+    }
+    double scale = last > first ? (double)GANTT_SVG_COLUMNS / (double)(last - first) : 1.0;
+    int axis = top + lanes * (GANTT_SVG_LANE_HEIGHT + gap);
+
+    GanttBlock *segments = (GanttBlock *)malloc(GANTT_SVG_COLUMNS * sizeof(GanttBlock));
+    FILE *file = segments != NULL ? fopen(filename, "w") : NULL;
+    if (file == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", filename);
+        free(segments);
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, READ_BLOCK_SIZE);
+
+    size_t length = strlen(filename);
+    int html = length >= 5 && strcmp(filename + length - 5, ".html") == 0;
+    if (html)
+        fprintf(file, "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Gantt chart</title></head>\n<body>\n");
+    fprintf(file,
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" font-family=\"monospace\" "
+            "font-size=\"12\">\n",
+            left + GANTT_SVG_COLUMNS + 40, axis + 30);
+
+    int ok = 1;
+    for (int c = 0; ok && c < lanes; c++)
+    {
+        int y = top + c * (GANTT_SVG_LANE_HEIGHT + gap);
+        fprintf(file, "<text x=\"4\" y=\"%d\">CPU %d</text>\n", y + GANTT_SVG_LANE_HEIGHT / 2 + 4, c);
+        fprintf(file, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#eee\"/>\n", left, y,
+                GANTT_SVG_COLUMNS, GANTT_SVG_LANE_HEIGHT);
+        if (charts[c].size == 0)
+            continue;
+
+        SimTime step;
+        int count = gantt_scale(charts[c].blocks, charts[c].size, GANTT_SVG_COLUMNS, segments, &step);
+        if (count < 0)
+            ok = 0;
+        for (int i = 0; i < count; i++)
+        {
+            const GanttBlock *segment = &segments[i];
+            if (segment->pid == -1)
+                continue; // the lane background shows idle time
+            double x = left + (double)(segment->start_time - first) * scale;
+            double width = (double)(segment->end_time - segment->start_time) * scale;
+            if (segment->pid == GANTT_SWITCH)
+                fprintf(file, "<rect x=\"%.2f\" y=\"%d\" width=\"%.2f\" height=\"%d\" fill=\"#333\">", x, y, width,
+                        GANTT_SVG_LANE_HEIGHT);
+            else if (segment->pid == GANTT_MIXED)
+                fprintf(file, "<rect x=\"%.2f\" y=\"%d\" width=\"%.2f\" height=\"%d\" fill=\"#999\">", x, y, width,
+                        GANTT_SVG_LANE_HEIGHT);
+            else
+                fprintf(file, "<rect x=\"%.2f\" y=\"%d\" width=\"%.2f\" height=\"%d\" fill=\"hsl(%u,65%%,60%%)\">",
+                        x, y, width, GANTT_SVG_LANE_HEIGHT, (unsigned)segment->pid * 47u % 360u);
+
+            if (segment->pid == GANTT_SWITCH)
+                fprintf(file, "<title>CS");
+            else if (segment->pid == GANTT_MIXED)
+                fprintf(file, "<title>several processes");
+            else
+                fprintf(file, "<title>P%d", segment->pid);
+            fprintf(file, " %lld-%lld</title></rect>\n", segment->start_time, segment->end_time);
+
+            if (segment->pid >= 0 && width >= 8.0 * (double)snprintf(NULL, 0, "P%d", segment->pid) + 4.0)
+                fprintf(file, "<text x=\"%.2f\" y=\"%d\">P%d</text>\n", x + 2.0, y + GANTT_SVG_LANE_HEIGHT / 2 + 4,
+                        segment->pid);
+        }
+    }
+
+    // Time axis: ten ticks across the run
+    fprintf(file, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"black\"/>\n", left, axis,
+            left + GANTT_SVG_COLUMNS, axis);
+    for (int tick = 0; tick <= 10; tick++)
+    {
+        int x = left + GANTT_SVG_COLUMNS * tick / 10;
+        fprintf(file, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"black\"/>\n", x, axis, x, axis + 4);
+        fprintf(file, "<text x=\"%d\" y=\"%d\" text-anchor=\"middle\">%lld</text>\n", x, axis + 18,
+                first + (last - first) * tick / 10);
+    }
+    fprintf(file, "</svg>\n");
+    if (html)
+        fprintf(file, "</body></html>\n");
+
+    free(segments);
+    ok = ok && !ferror(file);
+    if (fclose(file) != 0 || !ok)
+    {
+        printf("Error: Could not write '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// Calculate and display CPU utilization from the sink's running totals
+void calculate_and_display_cpu_utilization(const GanttSink *gantt)
+{
+    if (gantt->blocks == 0)
+    {
+        printf("CPU Utilization: N/A (no Gantt data)\n");
+        return;
+    }
+
+    SimTime total_time = gantt->last_end - gantt->first_start;
+    SimTime idle_time = gantt->idle_time;
+    SimTime busy_time = total_time - idle_time - gantt->switch_time;
+    float cpu_utilization = (total_time > 0) ? ((float)busy_time / total_time) * 100.0 : 0.0;
+
+    printf("\n===== CPU UTILIZATION =====\n");
+    printf("Total Time: %lld\n", total_time);
+    printf("Busy Time: %lld\n", busy_time);
+    printf("Idle Time: %lld\n", idle_time);
+    if (gantt->switch_cost > 0)
+    {
+        float overhead = (total_time > 0) ? ((float)gantt->switch_time / total_time) * 100.0 : 0.0;
+        printf("Context Switches: %d (cost %d each)\n", gantt->switches, gantt->switch_cost);
+        printf("Switch Overhead: %lld (%.2f%%)\n", gantt->switch_time, overhead);
+    }
+    printf("CPU Utilization: %.2f%%\n", cpu_utilization);
+}
+
+// Per-CPU and aggregate utilization from one sink per CPU. Every CPU is
+// measured over the whole run (earliest start to latest end on any CPU), so a
+// CPU that finished early counts as idle for the rest.
+void display_core_utilization(const GanttSink lanes[], int cores, int switch_cost)
+{
+    SimTime first = 0, last = 0, busy = 0, switch_time = 0;
+    int seen = 0, switches = 0;
+    for (int c = 0; c < cores; c++)
+    {
+        if (lanes[c].blocks == 0)
+            continue;
+        if (!seen || lanes[c].first_start < first)
+            first = lanes[c].first_start;
+        if (!seen || lanes[c].last_end > last)
+            last = lanes[c].last_end;
+        busy += lanes[c].busy_time;
+        seen = 1;
+    }
+    if (!seen)
+    {
+        printf("CPU Utilization: N/A (no Gantt data)\n");
+        return;
+    }
+
+    SimTime total_time = last - first;
+    printf("\n===== CPU UTILIZATION (%d CPUs) =====\n", cores);
+    for (int c = 0; c < cores; c++)
+    {
+        float utilization = total_time > 0 ? ((float)lanes[c].busy_time / total_time) * 100.0f : 0.0f;
+        printf("CPU %d: Busy %lld / %lld (%.2f%%)", c, lanes[c].busy_time, total_time, utilization);
+        if (switch_cost > 0)
+            printf(", %d switches", lanes[c].switches);
+        printf("\n");
+        switch_time += lanes[c].switch_time;
+        switches += lanes[c].switches;
+    }
+
+    SimTime capacity = total_time * cores;
+    float cpu_utilization = capacity > 0 ? ((float)busy / capacity) * 100.0f : 0.0f;
+    printf("Total Time: %lld\n", total_time);
+    printf("Busy Time (all CPUs): %lld\n", busy);
+    printf("Idle Time (all CPUs): %lld\n", capacity - busy - switch_time);
+    if (switch_cost > 0)
+    {
+        float overhead = capacity > 0 ? ((float)switch_time / capacity) * 100.0f : 0.0f;
+        printf("Context Switches: %d (cost %d each)\n", switches, switch_cost);
+        printf("Switch Overhead (all CPUs): %lld (%.2f%%)\n", switch_time, overhead);
+    }
+    printf("CPU Utilization: %.2f%%\n", cpu_utilization);
+}
+
+// --- Results Output (CSV / JSON Lines) ---
+
+static void results_flush(ResultsWriter *writer)
+{
+    if (writer->used > 0)
+        fwrite(writer->buffer, 1, writer->used, writer->out);
+    writer->used = 0;
+}
+
+// Append one formatted record, flushing first if it does not fit
+static void results_printf(ResultsWriter *writer, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    size_t space = RESULTS_BUFFER_SIZE - writer->used;
+    va_list retry;
+    va_copy(retry, args);
+    int length = vsnprintf(writer->buffer + writer->used, space, format, args);
+    if (length >= 0 && (size_t)length >= space)
+    {
+        results_flush(writer);
+        if ((size_t)length < RESULTS_BUFFER_SIZE)
+            length = vsnprintf(writer->buffer, RESULTS_BUFFER_SIZE, format, retry);
+        else
+        {
+            vfprintf(writer->out, format, retry); // Longer than the whole buffer
+            length = 0;
+        }
+    }
+    if (length > 0)
+        writer->used += (size_t)length;
+    va_end(retry);
+    va_end(args);
+}
+
+// Quote text for the writer's format (CSV doubles quotes, JSON escapes them)
+static const char *results_quote(const ResultsWriter *writer, const char *text, char *out, size_t size)
+{
+    size_t n = 0;
+    out[n++] = '"';
+    for (; *text != '\0' && n + 3 < size; text++)
+    {
+        if (*text == '"')
+            out[n++] = writer->format == RESULTS_CSV ? '"' : '\\';
+        else if (*text == '\\' && writer->format == RESULTS_JSON)
+            out[n++] = '\\';
+        out[n++] = *text;
+    }
+    out[n++] = '"';
+    out[n] = '\0';
+    return out;
+}
+
+// Start writing records to out; CSV output begins with one "#" header line
+// per record type. Returns 0 on success, -1 if the buffer can't be allocated.
+int results_writer_open(ResultsWriter *writer, FILE *out, int format)
+{
+    writer->out = out;
+    writer->format = format;
+    writer->used = 0;
+    writer->run = 0;
+    writer->buffer = (char *)malloc(RESULTS_BUFFER_SIZE);
+    if (writer->buffer == NULL)
+    {
+        printf("Error: Could not allocate the results buffer\n");
+        return -1;
+    }
+
+    if (format == RESULTS_CSV)
+        results_printf(writer, "#run,run,algorithm,quantum,cores,switch_cost\n"
+                               "#gantt,run,pid,start,end,core\n"
+                               "#process,run,pid,arrival,burst,priority,completion,turnaround,waiting\n"
+                               "#summary,run,processes,"
+                               "avg_waiting,p50_waiting,p95_waiting,p99_waiting,max_waiting,"
+                               "avg_turnaround,p50_turnaround,p95_turnaround,p99_turnaround,max_turnaround,"
+                               "avg_response,p50_response,p95_response,p99_response,max_response,"
+                               "avg_slowdown,max_slowdown,total_time,busy_time,idle_time,switch_time,switches,"
+                               "cpu_utilization\n"
+                               "#sweep,run,processes,avg_waiting,avg_turnaround,avg_response,p99_turnaround,"
+                               "cpu_utilization,switches,switch_overhead\n"
+                               "#stats,run,dispatches,queue_ops,selections,candidates,idle_jumps,gantt_merges,"
+                               "load_s,sort_s,schedule_s,metrics_s,render_s\n");
+    return 0;
+}
+
+// Write out whatever is still buffered and release the buffer
+void results_writer_close(ResultsWriter *writer)
+{
+    results_flush(writer);
+    fflush(writer->out);
+    free(writer->buffer);
+    writer->buffer = NULL;
+}
+
+// Start a new run: every following record carries its id (quantum 0 = none)
+void results_begin_run(ResultsWriter *writer, const char *algorithm, int quantum, int cores, int switch_cost)
+{
+    char name[128];
+    results_quote(writer, algorithm, name, sizeof(name));
+    writer->run++;
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "run,%d,%s,%d,%d,%d\n", writer->run, name, quantum, cores, switch_cost);
+    else
+        results_printf(writer,
+                       "{\"record\":\"run\",\"run\":%d,\"algorithm\":%s,\"quantum\":%d,\"cores\":%d,"
+                       "\"switch_cost\":%d}\n",
+                       writer->run, name, quantum, cores, switch_cost);
+}
+
+static void gantt_results_write(GanttSink *sink, const GanttBlock *block)
+{
+    ResultsWriter *writer = (ResultsWriter *)sink->context;
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "gantt,%d,%d,%lld,%lld,%d\n", writer->run, block->pid, block->start_time,
+                       block->end_time, block->core);
+    else
+        results_printf(writer, "{\"record\":\"gantt\",\"run\":%d,\"pid\":%d,\"start\":%lld,\"end\":%lld,\"core\":%d}\n",
+                       writer->run, block->pid, block->start_time, block->end_time, block->core);
+}
+
+// Write each block as a gantt record of the current run (pid -1 = idle, -2 = context switch)
+void gantt_sink_init_results(GanttSink *sink, ResultsWriter *writer)
+{
+    gantt_sink_init_summary(sink);
+    sink->write = gantt_results_write;
+    sink->context = writer;
+}
+
+// One process record (a finished table row or a completion reported by an engine)
+void results_write_process(ResultsWriter *writer, const Process *process)
+{
+    SimTime turnaround = process->turnaround_time;
+    SimTime waiting = process->waiting_time;
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "process,%d,%d,%lld,%lld,%d,%lld,%lld,%lld\n", writer->run, process->pid,
+                       process->arrival_time, process->burst_time, process->priority,
+                       process->completion_time, turnaround, waiting);
+    else
+        results_printf(writer,
+                       "{\"record\":\"process\",\"run\":%d,\"pid\":%d,\"arrival\":%lld,\"burst\":%lld,"
+                       "\"priority\":%d,\"completion\":%lld,\"turnaround\":%lld,\"waiting\":%lld}\n",
+                       writer->run, process->pid, process->arrival_time, process->burst_time,
+                       process->priority, process->completion_time, turnaround, waiting);
+}
+
+void results_write_processes(ResultsWriter *writer, const Process processes[], int n)
+{
+    for (int i = 0; i < n; i++)
+        results_write_process(writer, &processes[i]);
+}
+
+// One latency distribution: flat CSV columns, or a nested JSON object
+static void results_write_latency(ResultsWriter *writer, const char *name, const LatencyStats *stats)
+{
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, ",%.2f,%lld,%lld,%lld,%lld", stats->mean, stats->p50, stats->p95, stats->p99,
+                       stats->max);
+    else
+        results_printf(writer, ",\"%s\":{\"mean\":%.2f,\"p50\":%lld,\"p95\":%lld,\"p99\":%lld,\"max\":%lld}", name,
+                       stats->mean, stats->p50, stats->p95, stats->p99, stats->max);
+}
+
+// Summary record of the current run. Times are measured over the whole run on
+// every CPU, so idle_time includes the idle tails of multi-CPU runs.
+void results_write_summary(ResultsWriter *writer, const GanttSink *gantt, int cores, const ScheduleMetrics *metrics)
+{
+    SimTime total_time = gantt->blocks > 0 ? gantt->last_end - gantt->first_start : 0;
+    SimTime capacity = total_time * cores;
+    SimTime idle_time = capacity - gantt->busy_time - gantt->switch_time;
+    double utilization = capacity > 0 ? 100.0 * gantt->busy_time / capacity : 0.0;
+
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "summary,%d,%d", writer->run, metrics->processes);
+    else
+        results_printf(writer, "{\"record\":\"summary\",\"run\":%d,\"processes\":%d", writer->run,
+                       metrics->processes);
+    results_write_latency(writer, "waiting", &metrics->waiting);
+    results_write_latency(writer, "turnaround", &metrics->turnaround);
+    results_write_latency(writer, "response", &metrics->response);
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, ",%.2f,%.2f,%lld,%lld,%lld,%lld,%d,%.2f\n", metrics->avg_slowdown,
+                       metrics->max_slowdown, total_time, gantt->busy_time, idle_time, gantt->switch_time,
+                       gantt->switches, utilization);
+    else
+        results_printf(writer,
+                       ",\"avg_slowdown\":%.2f,\"max_slowdown\":%.2f,\"total_time\":%lld,\"busy_time\":%lld,"
+                       "\"idle_time\":%lld,\"switch_time\":%lld,\"switches\":%d,\"cpu_utilization\":%.2f}\n",
+                       metrics->avg_slowdown, metrics->max_slowdown, total_time, gantt->busy_time, idle_time,
+                       gantt->switch_time, gantt->switches, utilization);
+}
+
+// Metrics of one sweep configuration (the current run); sweeps keep no blocks
+void results_write_sweep(ResultsWriter *writer, const SweepResult *result)
+{
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "sweep,%d,%d,%.2f,%.2f,%.2f,%lld,%.2f,%d,%.2f\n", writer->run, result->processes,
+                       result->avg_waiting, result->avg_turnaround, result->avg_response, result->p99_turnaround,
+                       result->cpu_utilization, result->switches, result->switch_overhead);
+    else
+        results_printf(writer,
+                       "{\"record\":\"sweep\",\"run\":%d,\"processes\":%d,\"avg_waiting\":%.2f,"
+                       "\"avg_turnaround\":%.2f,\"avg_response\":%.2f,\"p99_turnaround\":%lld,"
+                       "\"cpu_utilization\":%.2f,\"switches\":%d,\"switch_overhead\":%.2f}\n",
+                       writer->run, result->processes, result->avg_waiting, result->avg_turnaround,
+                       result->avg_response, result->p99_turnaround, result->cpu_utilization, result->switches,
+                       result->switch_overhead);
+}
+
+// Instrumentation counters and phase times of the current run (see --stats)
+void results_write_stats(ResultsWriter *writer, const EngineStats *stats)
+{
+    const double *t = stats->seconds;
+    if (writer->format == RESULTS_CSV)
+        results_printf(writer, "stats,%d,%lld,%lld,%lld,%lld,%lld,%lld,%.6f,%.6f,%.6f,%.6f,%.6f\n", writer->run,
+                       stats->dispatches, stats->queue_ops, stats->selections, stats->candidates, stats->idle_jumps,
+                       stats->gantt_merges, t[PHASE_LOAD], t[PHASE_SORT], t[PHASE_SCHEDULE], t[PHASE_METRICS],
+                       t[PHASE_RENDER]);
+    else
+        results_printf(writer,
+                       "{\"record\":\"stats\",\"run\":%d,\"dispatches\":%lld,\"queue_ops\":%lld,"
+                       "\"selections\":%lld,\"candidates\":%lld,\"idle_jumps\":%lld,\"gantt_merges\":%lld,"
+                       "\"load_s\":%.6f,\"sort_s\":%.6f,\"schedule_s\":%.6f,\"metrics_s\":%.6f,\"render_s\":%.6f}\n",
+                       writer->run, stats->dispatches, stats->queue_ops, stats->selections, stats->candidates,
+                       stats->idle_jumps, stats->gantt_merges, t[PHASE_LOAD], t[PHASE_SORT], t[PHASE_SCHEDULE],
+                       t[PHASE_METRICS], t[PHASE_RENDER]);
+}
+
+// ============================================
+// ENGINE SUPPORT
+// ============================================
+
+// --- Process Sources ---
+
+// Fill the lookahead, clamping any arrival that goes back in time
+static void process_source_fill(ProcessSource *source)
+{
+    SimTime last_arrival = source->has_next ? source->next.arrival_time : 0;
+    int had_previous = source->has_next;
+
+    source->has_next = source->read(source->context, &source->next);
+    if (source->has_next && had_previous && source->next.arrival_time < last_arrival)
+    {
+        if (source->out_of_order++ == 0)
+            fprintf(stderr, "Warning: arrivals are not sorted; treating late records as arriving at %lld\n",
+                    last_arrival);
+        source->next.arrival_time = last_arrival;
+    }
+}
+
+void process_source_init(ProcessSource *source, ProcessSourceRead read, void *context)
+{
+    source->read = read;
+    source->context = context;
+    source->has_next = 0;
+    source->taken = 0;
+    source->out_of_order = 0;
+    source->resume = NULL;
+    process_source_fill(source);
+}
+
+static int array_source_read(void *context, Process *out)
+{
+    ArraySourceContext *array = (ArraySourceContext *)context;
+    if (array->pos >= array->count)
+        return 0;
+    *out = array->items[array->pos++];
+    return 1;
+}
+
+// Feed an arrival-sorted array; sequence numbers equal array indices
+void process_source_init_array(ProcessSource *source, ArraySourceContext *context, const Process processes[], int n)
+{
+    context->items = processes;
+    context->count = n;
+    context->pos = 0;
+    process_source_init(source, array_source_read, context);
+}
+
+// ProcessSourceRead over an open ProcessReader (streams a CSV file)
+int process_source_read_file(void *context, Process *out)
+{
+    return process_reader_next((ProcessReader *)context, out);
+}
+
+// Next record without consuming it, or NULL when the feed is exhausted
+const Process *process_source_peek(const ProcessSource *source)
+{
+    return source->has_next ? &source->next : NULL;
+}
+
+// Consume the lookahead record; returns its sequence number (caller checks peek first)
+int process_source_take(ProcessSource *source, Process *out)
+{
+    *out = source->next;
+    int seq = source->taken++;
+    process_source_fill(source);
+    return seq;
+}
+
+// --- Job Pool ---
+
+void job_pool_init(JobPool *pool)
+{
+    pool->jobs = NULL;
+    pool->keys = NULL;
+    pool->rank = NULL;
+    pool->rank_context = NULL;
+    pool->free_slots = NULL;
+    pool->free_count = 0;
+    pool->capacity = 0;
+    pool->live = 0;
+    pool->peak = 0;
+}
+
+void job_pool_free(JobPool *pool)
+{
+    scratch_free(pool->jobs);
+    scratch_free(pool->keys);
+    scratch_free(pool->free_slots);
+    job_pool_init(pool);
+}
+
+// Reserve a slot for a newly admitted job (pointers into jobs[] may move; slot numbers don't)
+int job_pool_acquire(JobPool *pool)
+{
+    if (pool->free_count == 0)
+    {
+        int grown = pool->capacity > 0 ? pool->capacity * 2 : 64;
+        size_t old = (size_t)pool->capacity;
+        pool->jobs = (Job *)scratch_grow(pool->jobs, old * sizeof(Job), (size_t)grown * sizeof(Job));
+        pool->keys = (JobKey *)scratch_grow(pool->keys, old * sizeof(JobKey), (size_t)grown * sizeof(JobKey));
+        pool->free_slots = (int *)scratch_grow(pool->free_slots, old * sizeof(int), (size_t)grown * sizeof(int));
+        for (int slot = grown - 1; slot >= pool->capacity; slot--)
+            pool->free_slots[pool->free_count++] = slot;
+        pool->capacity = grown;
+    }
+
+    pool->live++;
+    if (pool->live > pool->peak)
+        pool->peak = pool->live;
+    return pool->free_slots[--pool->free_count];
+}
+
+void job_pool_release(JobPool *pool, int slot)
+{
+    pool->free_slots[pool->free_count++] = slot;
+    pool->live--;
+}
+
+// Rank every job admitted from now on with rank(context, process)
+void job_pool_set_rank(JobPool *pool, JobRank rank, const void *context)
+{
+    pool->rank = rank;
+    pool->rank_context = context;
+}
+
+// Refresh a job's key from its process (call again after anything the rank reads changes)
+void job_pool_rank(JobPool *pool, int slot)
+{
+    const Job *job = &pool->jobs[slot];
+    JobKey *key = &pool->keys[slot];
+    key->rank = pool->rank(pool->rank_context, &job->process);
+    key->seq = job->seq;
+}
+
+// Move the next arrival from the source into a pool slot; returns the slot
+static int admit_next_job(ProcessSource *source, JobPool *pool)
+{
+    int slot = job_pool_acquire(pool);
+    pool->jobs[slot].seq = process_source_take(source, &pool->jobs[slot].process);
+    if (pool->rank != NULL)
+        job_pool_rank(pool, slot);
+    return slot;
+}
+
+// Lowest rank first; equal ranks fall back to input order, which the source
+// keeps in arrival order (FCFS)
+static int job_key_before(const void *context, int a, int b)
+{
+    const JobKey *keys = ((const JobPool *)context)->keys;
+    const JobKey *ka = &keys[a];
+    const JobKey *kb = &keys[b];
+
+    if (ka->rank != kb->rank)
+        return ka->rank < kb->rank;
+    return ka->seq < kb->seq;
+}
+
+// --- Gantt Timeline ---
+
+void gantt_timeline_init(GanttTimeline *timeline, const ScheduleListener *listener, int merge)
+{
+    timeline->listener = listener;
+    timeline->has_open = 0;
+    timeline->merge = merge;
+    timeline->core = 0;
+}
+
+// Record that pid (-1 = idle) held the CPU over [start_time, end_time)
+void gantt_timeline_append(GanttTimeline *timeline, int pid, SimTime start_time, SimTime end_time)
+{
+    // Back to back switches stay separate blocks so each one is counted
+    if (timeline->has_open && timeline->merge && pid != GANTT_SWITCH &&
+        timeline->open.pid == pid && timeline->open.end_time == start_time)
+    {
+        timeline->open.end_time = end_time;
+        STAT_ADD(gantt_merges, 1);
+        return;
+    }
+    if (pid == -1)
+        STAT_ADD(idle_jumps, 1);
+
+    gantt_timeline_flush(timeline);
+    timeline->open.pid = pid;
+    timeline->open.start_time = start_time;
+    timeline->open.end_time = end_time;
+    timeline->open.core = timeline->core;
+    timeline->has_open = 1;
+
+    // Without merging nothing can extend the block, so report it right away
+    if (!timeline->merge)
+        gantt_timeline_flush(timeline);
+}
+
+// Report the open block (call once the engine is done)
+void gantt_timeline_flush(GanttTimeline *timeline)
+{
+    if (timeline->has_open)
+    {
+        gantt_sink_emit(timeline->listener->gantt, &timeline->open);
+        timeline->has_open = 0;
+    }
+}
+
+// A CPU that last ran *last_pid is about to run pid at `time`: if that is a
+// different process, count the switch and, if the sink charges for switches,
+// emit a context switch block of its switch_cost.
+// Returns the time the process actually starts running.
+static SimTime charge_context_switch(GanttTimeline *timeline, int *last_pid, int pid, SimTime time)
+{
+    int previous = *last_pid;
+    *last_pid = pid;
+    if (previous < 0 || previous == pid)
+        return time;
+
+    GanttSink *sink = timeline->listener->gantt;
+    gantt_sink_count_switch(sink, timeline->core);
+    if (sink->switch_cost <= 0)
+        return time;
+
+    gantt_timeline_append(timeline, GANTT_SWITCH, time, time + sink->switch_cost);
+    TRACE(TRACE_DISPATCH, "[CS] Time %lld -> %lld (P%d -> P%d)\n", time, time + sink->switch_cost, previous, pid);
+    return time + sink->switch_cost;
+}
+
+// Engine dispatches p at `time` (after any context switch): remember the first one
+static void mark_started(Process *p, SimTime time)
+{
+    STAT_ADD(dispatches, 1);
+    if (!p->started)
+    {
+        p->started = 1;
+        p->first_run_time = time;
+    }
+}
+
+// Engine reports a finished process
+static void report_completion(const ScheduleListener *listener, Job *job)
+{
+    // The only place every completion passes through: derive the per-process
+    // results once here, so reports and listeners only read them
+    Process *p = &job->process;
+    p->turnaround_time = p->completion_time - p->arrival_time;
+    p->waiting_time = p->turnaround_time - p->burst_time;
+    listener->on_complete(listener->context, &job->process, job->seq);
+}
+
+// The next process has an empty burst and never needs the CPU: admit it and
+// complete it at its arrival, so it is reported like every other process
+static void complete_empty_burst(ProcessSource *source, JobPool *pool, const ScheduleListener *listener)
+{
+    int slot = admit_next_job(source, pool);
+    Process *p = &pool->jobs[slot].process;
+    p->completed = 1;
+    p->completion_time = p->arrival_time;
+    TRACE(TRACE_DISPATCH, "     [P%d has no burst, completed at arrival %lld]\n", p->pid, p->arrival_time);
+    report_completion(listener, &pool->jobs[slot]);
+    job_pool_release(pool, slot);
+}
+
+// Start an engine from the snapshot its source carries, if any (see resimulate)
+static void engine_resume(const ProcessSource *source, GanttTimeline *timeline, SimTime *time, int *last_pid)
+{
+    const EngineSnapshot *snapshot = source->resume;
+    if (snapshot == NULL)
+        return;
+    *time = snapshot->time;
+    *last_pid = snapshot->last_pid;
+    timeline->open = snapshot->open;
+    timeline->has_open = snapshot->has_open;
+}
+
+// Called after each completion: record a snapshot if the listener keeps them,
+// the engine holds no other job and the interval has passed
+static void engine_checkpoint(const GanttTimeline *timeline, const ProcessSource *source, const JobPool *pool,
+                              SimTime time, int last_pid, SimTime next_boost)
+{
+    SnapshotLog *log = timeline->listener->snapshots;
+    if (log == NULL || pool->live > 0 || time < log->next_due)
+        return;
+
+    if (log->count == log->capacity)
+    {
+        log->capacity = log->capacity > 0 ? log->capacity * 2 : 64;
+        log->items = (EngineSnapshot *)checked_realloc(log->items, (size_t)log->capacity * sizeof(EngineSnapshot));
+    }
+    EngineSnapshot *snapshot = &log->items[log->count++];
+    snapshot->time = time;
+    snapshot->taken = source->taken;
+    snapshot->last_pid = last_pid;
+    snapshot->next_boost = next_boost;
+    snapshot->open = timeline->open;
+    snapshot->has_open = timeline->has_open;
+    snapshot->totals = *timeline->listener->gantt;
+    log->next_due = time - time % log->interval + log->interval;
+}
+
+// --- In-Memory Adapters ---
+// Let the array-based algorithm functions drive the engines: the source walks
+// the array and the listener writes completed processes back into it.
+
+static void array_record_completion(void *context, const Process *process, int seq)
+{
+    Process *processes = (Process *)context;
+    processes[seq] = *process;
+}
+
+static void array_listener_init(ScheduleListener *listener, Process processes[], GanttSink *gantt)
+{
+    listener->gantt = gantt;
+    listener->on_complete = array_record_completion;
+    listener->context = processes;
+    listener->snapshots = NULL;
+}
+
+// ============================================
+// SCHEDULING ALGORITHMS (STUBS - TO BE IMPLEMENTED)
+// ============================================
+
+/*
+ * PREEMPTIVE ALGORITHM
+ * ---------------------
+ * TODO: Implement ONE of the following:
+ *   - SRTF (Shortest Remaining Time First)
+ *   - Preemptive Priority
+ *   - Round Robin (requires time quantum)
+ *
+ * Remember to:
+ *   1. Handle idle time when no process is available
+ *   2. Update the Gantt chart array
+ *   3. Set completion_time for each process
+ */
+// Move every process with arrival_time <= time from the source into the
+// ready queue. Zero-burst processes never need the CPU and complete at once.
+static void rr_admit_arrivals(ProcessSource *source, SimTime time, JobPool *pool, RingQueue *ready,
+                              const ScheduleListener *listener)
+{
+    const Process *next;
+    while ((next = process_source_peek(source)) != NULL && next->arrival_time <= time)
+    {
+        if (next->burst_time <= 0)
+        {
+            complete_empty_burst(source, pool, listener);
+            continue;
+        }
+        ring_queue_push(ready, admit_next_job(source, pool));
+    }
+}
+
+int round_robin_engine(ProcessSource *source, int quantum, const ScheduleListener *listener)
+{
+    TRACE(TRACE_SUMMARY, "\n===== PREEMPTIVE ROUND ROBIN ALGORITHM =====\n");
+
+    // The caller supplies the quantum (prompted or from the command line)
+    if (quantum <= 0)
+    {
+        printf("Invalid quantum, defaulting to 1.\n");
+        quantum = 1;
+    }
+    TRACE(TRACE_SUMMARY, "Time Quantum: %d\n", quantum);
+
+    const Process *first = process_source_peek(source);
+    if (first == NULL && source->resume == NULL)
+        return 0;
+
+    JobPool pool;
+    RingQueue ready;
+    GanttTimeline timeline;
+    job_pool_init(&pool);
+    if (ring_queue_init(&ready, 64) != 0)
+    {
+        printf("Error: Could not allocate Round Robin queue\n");
+        return 0;
+    }
+    gantt_timeline_init(&timeline, listener, 1); // merge contiguous slices
+
+    // Arrivals come in order, so the earliest one is first and each process is
+    // admitted exactly once
+    SimTime time = first != NULL ? first->arrival_time : 0;
+    int last_pid = -1; // Process the CPU ran last (for context switch cost)
+    engine_resume(source, &timeline, &time, &last_pid);
+
+    while (1)
+    {
+        // 1. Enqueue all processes that have already arrived
+        rr_admit_arrivals(source, time, &pool, &ready, listener);
+
+        // 2. If no one is ready, CPU idle until next arrival
+        if (ready.size == 0)
+        {
+            const Process *next = process_source_peek(source);
+            if (next == NULL)
+                break; // no more work
+
+            SimTime next_arrival = next->arrival_time;
+            gantt_timeline_append(&timeline, -1, time, next_arrival);
+
+            TRACE(TRACE_DISPATCH, "[IDLE] Time %lld -> %lld\n", time, next_arrival);
+            time = next_arrival;
+            continue;
+        }
+
+        // 3. Dequeue next process
+        int slot = ring_queue_pop(&ready);
+        Process *p = &pool.jobs[slot].process;
+
+        time = charge_context_switch(&timeline, &last_pid, p->pid, time);
+        mark_started(p, time);
+        SimTime run_for = (p->remaining_time < quantum) ? p->remaining_time : quantum;
+
+        // 4. Gantt handling: merge with previous block if same PID and contiguous
+        gantt_timeline_append(&timeline, p->pid, time, time + run_for);
+
+        TRACE(TRACE_DISPATCH, "[P%d] runs from %lld to %lld (remaining before run: %lld)\n",
+              p->pid, time, time + run_for, p->remaining_time);
+
+        time += run_for;
+        p->remaining_time -= run_for;
+
+        // 5. After advancing time, enqueue the arrivals from (start_time, time]
+        //    ahead of the process that just ran (may grow the pool, so p is stale after this)
+        rr_admit_arrivals(source, time, &pool, &ready, listener);
+        p = &pool.jobs[slot].process;
+
+        // 6. Not Finished? *insert_megamind_meme*
+        if (p->remaining_time == 0)
+        {
+            p->completed = 1;
+            p->completion_time = time;
+            TRACE(TRACE_DISPATCH, "     [P%d completed at time %lld]\n", p->pid, time);
+            report_completion(listener, &pool.jobs[slot]);
+            job_pool_release(&pool, slot);
+            engine_checkpoint(&timeline, source, &pool, time, last_pid, 0);
+        }
+        else
+        {
+            // Not finished: re-enqueue once at the back
+            ring_queue_push(&ready, slot);
+        }
+    }
+
+    gantt_timeline_flush(&timeline);
+    ring_queue_free(&ready);
+
+    TRACE(TRACE_SUMMARY, "\nAll processes reached end of Round Robin loop at time %lld\n", time);
+
+    int peak = pool.peak;
+    job_pool_free(&pool);
+    return peak;
+}
+
+void preemptive_algorithm(Process processes[], int n, int quantum, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    // Input is sorted by arrival (main sorts on every load)
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    round_robin_engine(&source, quantum, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+/*
+ * NON-PREEMPTIVE ALGORITHM 1
+ * ---------------------------
+ * TODO: Implement ONE of the following:
+ *   - FCFS (First Come First Serve)
+ *   - SJF (Shortest Job First)
+ *   - Non-preemptive Priority
+ *
+ * Remember to:
+ *   1. Handle idle time when no process is available
+ *   2. Update the Gantt chart array
+ *   3. Set completion_time for each process
+ */
+
+/*
+ * MODIFIED FCFS WITH AGING AND BURST-TIME AWARENESS
+ * ==================================================
+ * This algorithm addresses standard FCFS weaknesses:
+ *
+ * 1. AGING MECHANISM: Processes gain priority as they wait
+ *    - Each time unit waited increases effective priority
+ *    - Prevents indefinite waiting (starvation)
+ *
+ * 2. BURST-TIME AWARENESS: Shorter jobs get slight preference
+ *    - When multiple processes have similar wait times
+ *    - Reduces convoy effect without full preemption
+ *
+ * 3. DYNAMIC SCHEDULING: Re-evaluates at each completion
+ *    - Not purely first-come (like standard FCFS)
+ *    - Balances fairness with efficiency
+ *
+ * SCORING FORMULA:
+ * score = (wait_time * weights.aging) - (burst_time * weights.burst) - (priority * weights.priority)
+ *
+ * Higher score = Higher selection priority. The weights are passed in at run
+ * time; the defaults below are used when none are given.
+ */
+
+#define AGING_WEIGHT 2.0    // Default weights.aging
+#define BURST_WEIGHT 0.5    // Default weights.burst
+#define PRIORITY_WEIGHT 3.0 // Default weights.priority
+// The heap ranks keys rounded to this grid (1/1000), so two jobs whose keys
+// round to the same point tie and go to the earlier arrival. That is not the
+// scan's 0.001 tolerance: keys 0.0006 apart can round to neighbouring points,
+// and the heap then orders them where the scan calls them a tie. The heap is
+// exact whenever every key lies on the grid (e.g. the default weights, all
+// multiples of 0.5); otherwise it approximates the original rule, which
+// --aging-select scan keeps.
+#define AGING_KEY_GRID 1000.0
+
+void default_aging_weights(AgingWeights *weights)
+{
+    weights->aging = AGING_WEIGHT;
+    weights->burst = BURST_WEIGHT;
+    weights->priority = PRIORITY_WEIGHT;
+}
+
+// The score's wait term is current_time * weights.aging minus a per-process
+// constant, so at any instant every candidate shares the same time offset and
+// ranking by the time-independent key below picks the same process as ranking
+// by score. That lets the ready set live in a heap instead of being rescanned.
+static double aging_static_key(const Process *p, const AgingWeights *weights)
+{
+    return -(p->arrival_time * weights->aging) - (p->burst_time * weights->burst) - (p->priority * weights->priority);
+}
+
+// Rank = negated key on the AGING_KEY_GRID, computed once per job (context:
+// AgingWeights). The ranks are whole numbers, so comparing them is exact.
+static double aging_rank(const void *context, const Process *process)
+{
+    return floor(-aging_static_key(process, (const AgingWeights *)context) * AGING_KEY_GRID + 0.5);
+}
+
+// Highest key (lowest rank) first; equal ranks fall back to admission order,
+// which is arrival order (pure FCFS)
+static int aging_before(const void *context, int a, int b)
+{
+    const JobKey *keys = ((const JobPool *)context)->keys;
+    const JobKey *ka = &keys[a];
+    const JobKey *kb = &keys[b];
+
+    if (ka->rank != kb->rank)
+        return ka->rank < kb->rank;
+    return ka->seq < kb->seq;
+}
+
+// admit_next_job for the skeletons: key the job with the policy's rank
+// directly instead of through the pool
+ENGINE_INLINE int policy_admit(ProcessSource *source, JobPool *pool, const SchedulePolicy *policy,
+                               const void *context)
+{
+    int slot = job_pool_acquire(pool);
+    Job *job = &pool->jobs[slot];
+    job->seq = process_source_take(source, &job->process);
+    pool->keys[slot].rank = policy->rank(context, &job->process);
+    pool->keys[slot].seq = job->seq;
+    return slot;
+}
+
+// The non-preemptive loop shared by aging and SJF: admit what has arrived,
+// run the policy's pick to completion, idle until the next arrival when
+// nothing is ready. Returns the peak number of resident jobs (0 on failure).
+ENGINE_INLINE int nonpreemptive_engine(ProcessSource *source, const SchedulePolicy *policy, const void *context,
+                                       const ScheduleListener *listener)
+{
+    SimTime current_time = 0;
+    int last_pid = -1; // Process the CPU ran last (for context switch cost)
+
+    JobPool pool;
+    IndexHeap ready;
+    AgingScanSet scan;
+    GanttTimeline timeline;
+    job_pool_init(&pool);
+    if ((policy->scan ? aging_scan_init(&scan, 64) : index_heap_init(&ready, 64, policy->before, &pool)) != 0)
+    {
+        printf("Error: Could not allocate ready set\n");
+        return 0;
+    }
+    gantt_timeline_init(&timeline, listener, 0);
+    engine_resume(source, &timeline, &current_time, &last_pid);
+
+    while (1)
+    {
+        // Add every process that has arrived by current_time to the ready set
+        const Process *next;
+        while ((next = process_source_peek(source)) != NULL && next->arrival_time <= current_time)
+        {
+            int slot = policy_admit(source, &pool, policy, context);
+            if (policy->scan)
+                aging_scan_push(&scan, &pool.jobs[slot].process, slot);
+            else
+                heap_sift_push(&ready, slot, policy->before);
+        }
+
+        if ((policy->scan ? scan.size : ready.size) == 0)
+        {
+            if (next == NULL)
+                break; // all processes completed
+
+            // No process available - CPU idle until the next arrival
+            SimTime next_arrival = next->arrival_time;
+
+            // Add idle block to Gantt chart
+            gantt_timeline_append(&timeline, -1, current_time, next_arrival);
+
+            TRACE(TRACE_DISPATCH, "[IDLE] Time %lld -> %lld (waiting for next arrival)\n",
+                  current_time, next_arrival);
+            current_time = next_arrival;
+        }
+        else
+        {
+            // Execute the policy's pick to completion
+            int slot;
+            if (policy->scan)
+                slot = aging_scan_remove(&scan, aging_scan_select(&scan, current_time, (const AgingWeights *)context));
+            else
+                slot = heap_sift_pop(&ready, policy->before);
+            Process *p = &pool.jobs[slot].process;
+
+            SimTime wait_time = current_time - p->arrival_time;
+            current_time = charge_context_switch(&timeline, &last_pid, p->pid, current_time);
+            mark_started(p, current_time);
+            if (TRACE_ENABLED(TRACE_DISPATCH))
+                policy->trace_start(context, p, current_time, wait_time);
+
+            // Add to Gantt chart
+            gantt_timeline_append(&timeline, p->pid, current_time, current_time + p->burst_time);
+
+            // Update time and mark process as completed
+            current_time += p->burst_time;
+            p->completion_time = current_time;
+            p->completed = 1;
+
+            TRACE(TRACE_DISPATCH, policy->complete_format, current_time);
+            report_completion(listener, &pool.jobs[slot]);
+            job_pool_release(&pool, slot);
+            engine_checkpoint(&timeline, source, &pool, current_time, last_pid, 0);
+        }
+    }
+
+    gantt_timeline_flush(&timeline);
+    if (policy->scan)
+        aging_scan_free(&scan);
+    else
+        index_heap_free(&ready);
+
+    TRACE(TRACE_SUMMARY, "\nAll processes completed at time %lld\n", current_time);
+
+    int peak = pool.peak;
+    job_pool_free(&pool);
+    return peak;
+}
+
+static void aging_trace_start(const void *context, const Process *p, SimTime time, SimTime waited)
+{
+    const AgingWeights *order = (const AgingWeights *)context;
+
+    // Calculate dynamic score based on:
+    // 1. How long the process has been waiting (aging)
+    // 2. How short the burst time is (efficiency)
+    // 3. Original priority value (urgency)
+    double score = (waited * order->aging) - (p->burst_time * order->burst) - (p->priority * order->priority);
+    printf("[P%d] Start: %lld | Waited: %lld | Burst: %lld | Score: %.2f\n", p->pid, time, waited, p->burst_time,
+           score);
+}
+
+static const SchedulePolicy aging_heap_policy = {aging_rank, aging_before, 0, "     Complete: %lld\n",
+                                                 aging_trace_start};
+static const SchedulePolicy aging_scan_policy = {aging_rank, NULL, 1, "     Complete: %lld\n", aging_trace_start};
+
+// weights = NULL uses default_aging_weights(); selection (AGING_SELECT_*) picks heap or scan
+int aging_engine(ProcessSource *source, const AgingWeights *weights, int selection, const ScheduleListener *listener)
+{
+    AgingWeights order;
+    if (weights != NULL)
+        order = *weights;
+    else
+        default_aging_weights(&order);
+
+    TRACE(TRACE_SUMMARY, "\n===== Modified FCFS with Aging Algorithm =====\n");
+    TRACE(TRACE_SUMMARY, "Aging Weight: %.1f | Burst Weight: %.1f | Priority Weight: %.1f\n",
+          order.aging, order.burst, order.priority);
+
+    // Two calls rather than one with a chosen table: each gets its own copy of the loop
+    if (selection == AGING_SELECT_SCAN)
+        return nonpreemptive_engine(source, &aging_scan_policy, &order, listener);
+    return nonpreemptive_engine(source, &aging_heap_policy, &order, listener);
+}
+
+void modified_FCFS_with_aging(Process processes[], int n, const AgingWeights *weights, int selection, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    aging_engine(&source, weights, selection, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+/*
+ * NON-PREEMPTIVE ALGORITHM 2
+ * ---------------------------
+ * TODO: Implement ANOTHER non-preemptive algorithm (different from above)
+ *
+ * Remember to:
+ *   1. Handle idle time when no process is available
+ *   2. Update the Gantt chart array
+ *   3. Set completion_time for each process
+ */
+
+/*
+ * SHORTEST JOB FIRST (SJF) - Non-Preemptive
+ * ==========================================
+ * Selection Criteria: Process with the smallest burst_time
+ * Tie-breaker: If burst times are equal, use arrival_time (FCFS)
+ *
+ * Characteristics:
+ * - Optimal for minimizing average waiting time
+ * - Non-preemptive: once a process starts, it runs to completion
+ * - May cause starvation for longer processes if short ones keep arriving
+ */
+
+// Shortest burst first (job_key_before breaks ties by arrival time, then input order)
+static double sjf_rank(const void *context, const Process *process)
+{
+    (void)context;
+    return process->burst_time;
+}
+
+static void sjf_trace_start(const void *context, const Process *p, SimTime time, SimTime waited)
+{
+    (void)context;
+    printf("[P%d] Start: %lld | Arrival: %lld | Waited: %lld | Burst: %lld (shortest available)\n", p->pid, time,
+           p->arrival_time, waited, p->burst_time);
+}
+
+static const SchedulePolicy sjf_policy = {sjf_rank, job_key_before, 0, "     Completed at time %lld\n",
+                                          sjf_trace_start};
+
+int sjf_engine(ProcessSource *source, const ScheduleListener *listener)
+{
+    TRACE(TRACE_SUMMARY, "\n===== SHORTEST JOB FIRST (SJF) - Non-Preemptive =====\n");
+    return nonpreemptive_engine(source, &sjf_policy, NULL, listener);
+}
+
+void non_preemptive_algorithm_2(Process processes[], int n, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    sjf_engine(&source, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+/*
+ * SRTF AND PREEMPTIVE PRIORITY
+ * =============================
+ * SRTF: the ready process with the least remaining_time holds the CPU.
+ * Preemptive Priority: the ready process with the lowest priority number
+ * holds the CPU. Both fall back to arrival time, then input order.
+ *
+ * A running process can only lose the CPU when something arrives, so the
+ * engine never steps one time unit at a time: it runs the best process up to
+ * min(its completion, the next arrival), puts it back in the heap and picks
+ * again. That is O((n + preemptions) log n) however long the bursts are. A
+ * newcomer that does not beat the running process leaves the Gantt chart
+ * unchanged (contiguous slices of one PID are merged).
+ */
+
+static double srtf_rank(const void *context, const Process *process)
+{
+    (void)context;
+    return process->remaining_time;
+}
+
+static double priority_rank(const void *context, const Process *process)
+{
+    (void)context;
+    return process->priority;
+}
+
+static void preemptive_trace_start(const void *context, const Process *p, SimTime time, SimTime waited)
+{
+    (void)context;
+    (void)waited;
+    printf("[P%d] Start: %lld | Arrival: %lld | Remaining: %lld | Priority: %d\n", p->pid, time, p->arrival_time,
+           p->remaining_time, p->priority);
+}
+
+static const SchedulePolicy srtf_policy = {srtf_rank, job_key_before, 0, "     Completed at time %lld\n",
+                                           preemptive_trace_start};
+static const SchedulePolicy priority_policy = {priority_rank, job_key_before, 0, "     Completed at time %lld\n",
+                                               preemptive_trace_start};
+
+// Event-driven preemptive scheduling over a heap ordered by the policy (SRTF
+// and Preemptive Priority; the scan set is not supported here)
+ENGINE_INLINE int preemptive_engine(ProcessSource *source, const SchedulePolicy *policy, const void *context,
+                                    const ScheduleListener *listener)
+{
+    SimTime current_time = 0;
+    int preemptions = 0;
+    int running = -1;  // Slot that held the CPU in the previous slice
+    int last_pid = -1; // Process the CPU ran last (for context switch cost)
+
+    JobPool pool;
+    IndexHeap ready;
+    GanttTimeline timeline;
+    job_pool_init(&pool);
+    if (index_heap_init(&ready, 64, policy->before, &pool) != 0)
+    {
+        printf("Error: Could not allocate ready heap\n");
+        return 0;
+    }
+    gantt_timeline_init(&timeline, listener, 1); // merge slices a newcomer did not interrupt
+    engine_resume(source, &timeline, &current_time, &last_pid);
+
+    while (1)
+    {
+        // Add every process that has arrived by current_time to the ready set
+        const Process *next;
+        while ((next = process_source_peek(source)) != NULL && next->arrival_time <= current_time)
+            heap_sift_push(&ready, policy_admit(source, &pool, policy, context), policy->before);
+
+        if (ready.size == 0)
+        {
+            if (next == NULL)
+                break; // all processes completed
+
+            // No process available - CPU idle until the next arrival
+            gantt_timeline_append(&timeline, -1, current_time, next->arrival_time);
+            TRACE(TRACE_DISPATCH, "[IDLE] Time %lld -> %lld (waiting for next arrival)\n",
+                  current_time, next->arrival_time);
+            current_time = next->arrival_time;
+            running = -1;
+            continue;
+        }
+
+        int slot = heap_sift_pop(&ready, policy->before);
+        Process *p = &pool.jobs[slot].process;
+        if (slot != running)
+        {
+            if (running >= 0)
+            {
+                preemptions++;
+                TRACE(TRACE_DISPATCH, "     [P%d preempted at time %lld]\n", pool.jobs[running].process.pid,
+                      current_time);
+            }
+            // The same slot again means the same process, so only a change of slot can cost a switch
+            current_time = charge_context_switch(&timeline, &last_pid, p->pid, current_time);
+            mark_started(p, current_time);
+            if (TRACE_ENABLED(TRACE_DISPATCH))
+                policy->trace_start(context, p, current_time, current_time - p->arrival_time);
+        }
+
+        // Run until completion or the next arrival, whichever comes first (an
+        // arrival during the switch is only looked at once the switch is done)
+        SimTime run_until = current_time + p->remaining_time;
+        if (next != NULL && next->arrival_time < run_until)
+            run_until = next->arrival_time > current_time ? next->arrival_time : current_time;
+
+        if (run_until > current_time || p->remaining_time == 0)
+            gantt_timeline_append(&timeline, p->pid, current_time, run_until);
+        p->remaining_time -= run_until - current_time;
+        current_time = run_until;
+
+        if (p->remaining_time == 0)
+        {
+            p->completed = 1;
+            p->completion_time = current_time;
+            TRACE(TRACE_DISPATCH, policy->complete_format, current_time);
+            report_completion(listener, &pool.jobs[slot]);
+            job_pool_release(&pool, slot);
+            running = -1;
+            engine_checkpoint(&timeline, source, &pool, current_time, last_pid, 0);
+        }
+        else
+        {
+            // Back into the heap (re-ranked: SRTF's remaining time has dropped);
+            // the arrivals admitted next decide whether it keeps the CPU
+            pool.keys[slot].rank = policy->rank(context, p);
+            heap_sift_push(&ready, slot, policy->before);
+            running = slot;
+        }
+    }
+
+    gantt_timeline_flush(&timeline);
+    index_heap_free(&ready);
+
+    TRACE(TRACE_SUMMARY, "\nAll processes completed at time %lld (%d preemptions)\n", current_time, preemptions);
+
+    int peak = pool.peak;
+    job_pool_free(&pool);
+    return peak;
+}
+
+int srtf_engine(ProcessSource *source, const ScheduleListener *listener)
+{
+    TRACE(TRACE_SUMMARY, "\n===== SHORTEST REMAINING TIME FIRST (SRTF) - Preemptive =====\n");
+    return preemptive_engine(source, &srtf_policy, NULL, listener);
+}
+
+int priority_engine(ProcessSource *source, const ScheduleListener *listener)
+{
+    TRACE(TRACE_SUMMARY, "\n===== PREEMPTIVE PRIORITY (lower number = higher priority) =====\n");
+    return preemptive_engine(source, &priority_policy, NULL, listener);
+}
+
+void srtf_algorithm(Process processes[], int n, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    srtf_engine(&source, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+void preemptive_priority_algorithm(Process processes[], int n, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    priority_engine(&source, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+/*
+ * MULTILEVEL FEEDBACK QUEUE (MLFQ)
+ * =================================
+ * Round Robin over several levels, each with its own quantum:
+ *   1. New arrivals enter level 0 (the top, usually the shortest quantum)
+ *   2. The CPU always serves the highest non-empty level, FIFO within it
+ *   3. A job that uses its whole quantum without finishing drops one level
+ *      (the bottom level just round-robins)
+ *   4. Every boost_interval time units every waiting job returns to level 0,
+ *      so long jobs stuck at the bottom cannot starve (the same idea as
+ *      aging, applied to levels)
+ *
+ * Slices are not interrupted, exactly as in round_robin_engine: arrivals
+ * during a slice are queued before the job that just ran. Each level is a
+ * ring queue and a bitmap records which levels are non-empty, so picking the
+ * next job is a find-first-set on one word. With one level and no boost the
+ * schedule is the same as round_robin_engine with that quantum.
+ */
+
+void default_mlfq_config(MlfqConfig *config)
+{
+    config->levels = MLFQ_DEFAULT_LEVELS;
+    for (int level = 0; level < MLFQ_DEFAULT_LEVELS; level++)
+        config->quanta[level] = MLFQ_DEFAULT_QUANTUM << level;
+    config->boost_interval = MLFQ_DEFAULT_BOOST;
+}
+
+// Index of the lowest set bit (bits must be non-zero)
+static int lowest_set_bit(uint32_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#else
+    int index = 0;
+    while ((bits & 1u) == 0)
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+typedef struct
+{
+    RingQueue queues[MLFQ_MAX_LEVELS];
+    uint32_t non_empty; // Bit i set = queues[i] has jobs
+    int levels;
+} MlfqLevels;
+
+static void mlfq_push(MlfqLevels *mlfq, JobPool *pool, int slot, int level)
+{
+    pool->jobs[slot].level = level;
+    ring_queue_push(&mlfq->queues[level], slot);
+    mlfq->non_empty |= 1u << level;
+}
+
+static int mlfq_pop(MlfqLevels *mlfq)
+{
+    int level = lowest_set_bit(mlfq->non_empty);
+    int slot = ring_queue_pop(&mlfq->queues[level]);
+    if (mlfq->queues[level].size == 0)
+        mlfq->non_empty &= ~(1u << level);
+    return slot;
+}
+
+// Move every waiting job back to level 0, keeping level order then FIFO order
+// Returns the number of jobs moved
+static int mlfq_boost(MlfqLevels *mlfq, JobPool *pool)
+{
+    int moved = 0;
+    for (int level = 1; level < mlfq->levels; level++)
+    {
+        RingQueue *queue = &mlfq->queues[level];
+        while (queue->size > 0)
+        {
+            mlfq_push(mlfq, pool, ring_queue_pop(queue), 0);
+            moved++;
+        }
+        mlfq->non_empty &= ~(1u << level);
+    }
+    return moved;
+}
+
+// Zero-burst processes never need the CPU and complete at once, as in rr_admit_arrivals
+static void mlfq_admit_arrivals(ProcessSource *source, SimTime time, JobPool *pool, MlfqLevels *mlfq,
+                                const ScheduleListener *listener)
+{
+    const Process *next;
+    while ((next = process_source_peek(source)) != NULL && next->arrival_time <= time)
+    {
+        if (next->burst_time <= 0)
+        {
+            complete_empty_burst(source, pool, listener);
+            continue;
+        }
+        mlfq_push(mlfq, pool, admit_next_job(source, pool), 0);
+    }
+}
+
+// config = NULL uses default_mlfq_config()
+int mlfq_engine(ProcessSource *source, const MlfqConfig *config, const ScheduleListener *listener)
+{
+    MlfqConfig defaults;
+    if (config == NULL)
+    {
+        default_mlfq_config(&defaults);
+        config = &defaults;
+    }
+
+    TRACE(TRACE_SUMMARY, "\n===== MULTILEVEL FEEDBACK QUEUE (MLFQ) =====\n");
+    int levels = config->levels < 1 ? 1 : (config->levels > MLFQ_MAX_LEVELS ? MLFQ_MAX_LEVELS : config->levels);
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+    {
+        printf("Levels: %d | Quanta:", levels);
+        for (int level = 0; level < levels; level++)
+            printf(" %d", config->quanta[level] > 0 ? config->quanta[level] : 1);
+        if (config->boost_interval > 0)
+            printf(" | Boost every %d\n", config->boost_interval);
+        else
+            printf(" | No boost\n");
+    }
+
+    const Process *first = process_source_peek(source);
+    if (first == NULL && source->resume == NULL)
+        return 0;
+
+    JobPool pool;
+    MlfqLevels mlfq;
+    GanttTimeline timeline;
+    job_pool_init(&pool);
+    mlfq.non_empty = 0;
+    mlfq.levels = levels;
+    for (int level = 0; level < levels; level++)
+    {
+        if (ring_queue_init(&mlfq.queues[level], 64) != 0)
+        {
+            printf("Error: Could not allocate MLFQ level %d\n", level);
+            for (int i = 0; i < level; i++)
+                ring_queue_free(&mlfq.queues[i]);
+            return 0;
+        }
+    }
+    gantt_timeline_init(&timeline, listener, 1); // merge contiguous slices
+
+    SimTime time = first != NULL ? first->arrival_time : 0;
+    SimTime next_boost = config->boost_interval > 0 ? time + config->boost_interval : 0;
+    int last_pid = -1; // Process the CPU ran last (for context switch cost)
+    engine_resume(source, &timeline, &time, &last_pid);
+    if (source->resume != NULL)
+        next_boost = source->resume->next_boost;
+
+    while (1)
+    {
+        // 1. Enqueue all processes that have already arrived (top level)
+        mlfq_admit_arrivals(source, time, &pool, &mlfq, listener);
+
+        // 2. If no one is ready, CPU idle until next arrival
+        if (mlfq.non_empty == 0)
+        {
+            const Process *next = process_source_peek(source);
+            if (next == NULL)
+                break; // no more work
+
+            gantt_timeline_append(&timeline, -1, time, next->arrival_time);
+            TRACE(TRACE_DISPATCH, "[IDLE] Time %lld -> %lld\n", time, next->arrival_time);
+            time = next->arrival_time;
+            continue;
+        }
+
+        // 3. Highest non-empty level, FIFO within it
+        int slot = mlfq_pop(&mlfq);
+        int level = pool.jobs[slot].level;
+        Process *p = &pool.jobs[slot].process;
+        time = charge_context_switch(&timeline, &last_pid, p->pid, time);
+        mark_started(p, time);
+        int quantum = config->quanta[level] > 0 ? config->quanta[level] : 1;
+        SimTime run_for = p->remaining_time < quantum ? p->remaining_time : quantum;
+        gantt_timeline_append(&timeline, p->pid, time, time + run_for);
+
+        TRACE(TRACE_DISPATCH, "[P%d] L%d runs from %lld to %lld (remaining before run: %lld)\n",
+              p->pid, level, time, time + run_for, p->remaining_time);
+
+        time += run_for;
+        p->remaining_time -= run_for;
+
+        // 4. Arrivals from (start_time, time] go ahead of the job that just ran
+        mlfq_admit_arrivals(source, time, &pool, &mlfq, listener);
+        p = &pool.jobs[slot].process;
+
+        int finished = p->remaining_time == 0;
+        if (finished)
+        {
+            p->completed = 1;
+            p->completion_time = time;
+            TRACE(TRACE_DISPATCH, "     [P%d completed at time %lld]\n", p->pid, time);
+            report_completion(listener, &pool.jobs[slot]);
+            job_pool_release(&pool, slot);
+        }
+        else
+        {
+            // Used the whole quantum: one level down
+            int next_level = level + 1 < levels ? level + 1 : level;
+            if (next_level != level)
+                TRACE(TRACE_DISPATCH, "     [P%d demoted to L%d]\n", p->pid, next_level);
+            mlfq_push(&mlfq, &pool, slot, next_level);
+        }
+
+        // 5. Periodic boost (skipping any boosts that fell inside a long slice or idle gap)
+        if (next_boost > 0 && time >= next_boost)
+        {
+            int moved = mlfq_boost(&mlfq, &pool);
+            if (moved > 0)
+                TRACE(TRACE_DISPATCH, "[BOOST] Time %lld: %d jobs back to L0\n", time, moved);
+            next_boost += ((time - next_boost) / config->boost_interval + 1) * config->boost_interval;
+        }
+        if (finished)
+            engine_checkpoint(&timeline, source, &pool, time, last_pid, next_boost);
+    }
+
+    gantt_timeline_flush(&timeline);
+    for (int level = 0; level < levels; level++)
+        ring_queue_free(&mlfq.queues[level]);
+
+    TRACE(TRACE_SUMMARY, "\nAll processes reached end of MLFQ loop at time %lld\n", time);
+
+    int peak = pool.peak;
+    job_pool_free(&pool);
+    return peak;
+}
+
+void mlfq_algorithm(Process processes[], int n, const MlfqConfig *config, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    mlfq_engine(&source, config, &listener);
+
+    // Display CPU utilization
+    if (TRACE_ENABLED(TRACE_SUMMARY))
+        calculate_and_display_cpu_utilization(gantt);
+}
+
+// ============================================
+// MULTI-CPU SCHEDULING
+// ============================================
+// config->cores identical CPUs share one arrival stream. With QUEUE_GLOBAL
+// every idle CPU takes the next job from one shared ready set; with
+// QUEUE_PER_CORE each arrival joins the least loaded CPU's queue, a preempted
+// job goes back on the CPU it ran on, and a CPU whose queue is empty steals
+// the next job from the fullest other queue.
+//
+// The ready sets are the ones the single-CPU engines use (FIFO ring for
+// Round Robin, index heap with the same ordering for SJF and aging), and the
+// event order at each instant matches them too: finished slices, then
+// arrivals, then preempted jobs, then dispatch in CPU order. With one CPU the
+// schedule is the same as round_robin_engine/sjf_engine/aging_engine.
+
+// One ready set: FIFO for Round Robin, heap for the non-preemptive algorithms
+typedef struct
+{
+    RingQueue fifo;
+    IndexHeap heap;
+    int use_heap;
+} ReadySet;
+
+static int ready_set_init(ReadySet *ready, HeapBefore before, const void *context)
+{
+    ready->use_heap = before != NULL;
+    if (ready->use_heap)
+        return index_heap_init(&ready->heap, 64, before, context);
+    return ring_queue_init(&ready->fifo, 64);
+}
+
+static void ready_set_free(ReadySet *ready)
+{
+    if (ready->use_heap)
+        index_heap_free(&ready->heap);
+    else
+        ring_queue_free(&ready->fifo);
+}
+
+static int ready_set_size(const ReadySet *ready)
+{
+    return ready->use_heap ? ready->heap.size : ready->fifo.size;
+}
+
+static void ready_set_push(ReadySet *ready, int slot)
+{
+    if (ready->use_heap)
+        index_heap_push(&ready->heap, slot);
+    else
+        ring_queue_push(&ready->fifo, slot);
+}
+
+static int ready_set_pop(ReadySet *ready)
+{
+    return ready->use_heap ? index_heap_pop(&ready->heap) : ring_queue_pop(&ready->fifo);
+}
+
+typedef struct
+{
+    int slot;               // Job on the CPU, -1 = idle
+    SimTime busy_until;     // End of the running slice
+    SimTime idle_since;     // Start of the current idle period
+    int last_pid;           // Process this CPU ran last (for context switch cost)
+    GanttTimeline timeline; // This CPU's Gantt lane
+} CpuState;
+
+// Queue an arrival: the shared queue, or the CPU with the fewest queued plus running jobs
+static int least_loaded_queue(const ReadySet queues[], const CpuState cpus[], int queue_count)
+{
+    int best = 0, best_load = 0;
+    for (int q = 0; q < queue_count; q++)
+    {
+        int load = ready_set_size(&queues[q]) + (cpus[q].slot >= 0);
+        if (q == 0 || load < best_load)
+        {
+            best = q;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// Next job for CPU c: its own (or the shared) queue, else steal from the fullest
+// Returns -1 if every queue is empty
+static int take_ready_job(ReadySet queues[], int queue_count, int c)
+{
+    int own = queue_count > 1 ? c : 0;
+    if (ready_set_size(&queues[own]) > 0)
+        return ready_set_pop(&queues[own]);
+
+    int victim = -1, most = 0;
+    for (int q = 0; q < queue_count; q++)
+    {
+        if (ready_set_size(&queues[q]) > most)
+        {
+            most = ready_set_size(&queues[q]);
+            victim = q;
+        }
+    }
+    if (victim < 0)
+        return -1;
+    TRACE(TRACE_DISPATCH, "[CPU%d] steals from CPU%d (%d queued)\n", c, victim, most);
+    return ready_set_pop(&queues[victim]);
+}
+
+// Returns the peak number of jobs held in memory at once
+int multicore_engine(ProcessSource *source, const MulticoreConfig *config, const ScheduleListener *listener)
+{
+    int cores = config->cores < 1 ? 1 : (config->cores > MAX_CORES ? MAX_CORES : config->cores);
+    int preemptive = config->algorithm == ALG_ROUND_ROBIN;
+    int quantum = config->quantum;
+    int queue_count = config->queues == QUEUE_PER_CORE ? cores : 1;
+
+    TRACE(TRACE_SUMMARY, "\n===== MULTI-CPU SCHEDULING: %d CPUs, %s =====\n", cores,
+          queue_count > 1 ? "per-CPU queues with work stealing" : "global ready queue");
+    if (preemptive && quantum <= 0)
+    {
+        printf("Invalid quantum, defaulting to 1.\n");
+        quantum = 1;
+    }
+    if (preemptive)
+        TRACE(TRACE_SUMMARY, "Time Quantum: %d\n", quantum);
+
+    const Process *first = process_source_peek(source);
+    if (first == NULL)
+        return 0;
+
+    JobPool pool;
+    job_pool_init(&pool);
+
+    HeapBefore before = NULL;
+    if (config->algorithm == ALG_AGING)
+    {
+        before = aging_before;
+        job_pool_set_rank(&pool, aging_rank, &config->weights);
+    }
+    else if (config->algorithm == ALG_SJF)
+    {
+        before = job_key_before;
+        job_pool_set_rank(&pool, sjf_rank, NULL);
+    }
+
+    ReadySet *queues = (ReadySet *)scratch_alloc((size_t)queue_count * sizeof(ReadySet));
+    CpuState *cpus = (CpuState *)scratch_alloc((size_t)cores * sizeof(CpuState));
+    int *preempted = (int *)scratch_alloc((size_t)cores * 2 * sizeof(int)); // (CPU, slot) pairs
+    int ready_ok = 0;
+    while (queues != NULL && ready_ok < queue_count && ready_set_init(&queues[ready_ok], before, &pool) == 0)
+        ready_ok++;
+    if (cpus == NULL || preempted == NULL || ready_ok < queue_count)
+    {
+        printf("Error: Could not allocate state for %d CPUs\n", cores);
+        for (int q = 0; q < ready_ok; q++)
+            ready_set_free(&queues[q]);
+        scratch_free(queues);
+        scratch_free(cpus);
+        scratch_free(preempted);
+        return 0;
+    }
+
+    // Round Robin starts at the first arrival like round_robin_engine; the
+    // others start at 0 and report the leading idle time like sjf_engine
+    SimTime time = preemptive ? first->arrival_time : 0;
+    for (int c = 0; c < cores; c++)
+    {
+        cpus[c].slot = -1;
+        cpus[c].idle_since = time;
+        cpus[c].last_pid = -1;
+        gantt_timeline_init(&cpus[c].timeline, listener, preemptive);
+        cpus[c].timeline.core = c;
+    }
+
+    while (1)
+    {
+        // 1. Slices ending now: completions are reported, preempted jobs wait for step 3
+        int preempted_count = 0;
+        for (int c = 0; c < cores; c++)
+        {
+            if (cpus[c].slot < 0 || cpus[c].busy_until != time)
+                continue;
+
+            int slot = cpus[c].slot;
+            Process *p = &pool.jobs[slot].process;
+            cpus[c].slot = -1;
+            cpus[c].idle_since = time;
+            if (preemptive && p->remaining_time > 0)
+            {
+                preempted[2 * preempted_count] = c;
+                preempted[2 * preempted_count + 1] = slot;
+                preempted_count++;
+                continue;
+            }
+
+            p->completed = 1;
+            p->completion_time = time;
+            TRACE(TRACE_DISPATCH, "     [CPU%d] P%d completed at time %lld\n", c, p->pid, time);
+            report_completion(listener, &pool.jobs[slot]);
+            job_pool_release(&pool, slot);
+        }
+
+        // 2. Arrivals up to now (Round Robin completes empty bursts at once like round_robin_engine)
+        const Process *next;
+        while ((next = process_source_peek(source)) != NULL && next->arrival_time <= time)
+        {
+            if (preemptive && next->burst_time <= 0)
+            {
+                complete_empty_burst(source, &pool, listener);
+                continue;
+            }
+            int q = least_loaded_queue(queues, cpus, queue_count);
+            ready_set_push(&queues[q], admit_next_job(source, &pool));
+        }
+
+        // 3. Preempted jobs go behind the arrivals, on the queue of the CPU they ran on
+        for (int i = 0; i < preempted_count; i++)
+        {
+            int c = preempted[2 * i];
+            ready_set_push(&queues[queue_count > 1 ? c : 0], preempted[2 * i + 1]);
+        }
+
+        // 4. Dispatch every idle CPU
+        for (int c = 0; c < cores; c++)
+        {
+            if (cpus[c].slot >= 0)
+                continue;
+            int slot = take_ready_job(queues, queue_count, c);
+            if (slot < 0)
+                break; // every queue is empty
+
+            Process *p = &pool.jobs[slot].process;
+            if (time > cpus[c].idle_since)
+            {
+                gantt_timeline_append(&cpus[c].timeline, -1, cpus[c].idle_since, time);
+                TRACE(TRACE_DISPATCH, "[CPU%d] [IDLE] Time %lld -> %lld\n", c, cpus[c].idle_since, time);
+            }
+
+            SimTime run_for = p->burst_time;
+            if (preemptive)
+            {
+                run_for = p->remaining_time < quantum ? p->remaining_time : quantum;
+                p->remaining_time -= run_for;
+            }
+
+            SimTime start = charge_context_switch(&cpus[c].timeline, &cpus[c].last_pid, p->pid, time);
+            mark_started(p, start);
+            TRACE(TRACE_DISPATCH, "[CPU%d] P%d runs from %lld to %lld (arrived %lld)\n",
+                  c, p->pid, start, start + run_for, p->arrival_time);
+            gantt_timeline_append(&cpus[c].timeline, p->pid, start, start + run_for);
+            cpus[c].slot = slot;
+            cpus[c].busy_until = start + run_for;
+        }
+
+        // 5. Advance to the next slice end or arrival
+        int has_event = 0;
+        SimTime next_time = 0;
+        for (int c = 0; c < cores; c++)
+        {
+            if (cpus[c].slot >= 0 && (!has_event || cpus[c].busy_until < next_time))
+            {
+                next_time = cpus[c].busy_until;
+                has_event = 1;
+            }
+        }
+        if ((next = process_source_peek(source)) != NULL && (!has_event || next->arrival_time < next_time))
+        {
+            next_time = next->arrival_time;
+            has_event = 1;
+        }
+        if (!has_event)
+            break; // all processes completed
+        time = next_time;
+    }
+
+    for (int c = 0; c < cores; c++)
+        gantt_timeline_flush(&cpus[c].timeline);
+    for (int q = 0; q < queue_count; q++)
+        ready_set_free(&queues[q]);
+    scratch_free(queues);
+    scratch_free(cpus);
+    scratch_free(preempted);
+
+    TRACE(TRACE_SUMMARY, "\nAll processes completed at time %lld\n", time);
+
+    int peak = pool.peak;
+    job_pool_free(&pool);
+    return peak;
+}
+
+// gantt receives every CPU's blocks (block.core tells them apart); use a
+// lanes sink (gantt_sink_init_lanes) to keep per-CPU charts or totals
+void multicore_algorithm(Process processes[], int n, const MulticoreConfig *config, GanttSink *gantt)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    array_listener_init(&listener, processes, gantt);
+    multicore_engine(&source, config, &listener);
+}
+
+// ============================================
+// PARALLEL SWEEPS
+// ============================================
+// Each configuration is an independent simulation over the same arrival-sorted
+// table. Workers never copy or modify the table: an array source reads it and
+// a metrics listener keeps only running totals, so a sweep costs one table in
+// memory however many configurations and threads it uses.
+//
+// Scheduling is work-stealing: every worker owns a contiguous slice of the
+// configuration list and runs it front to back; a worker that runs dry takes
+// the last configuration from the fullest other slice. Configurations take
+// very different times (small quanta are slow), so static slices alone would
+// leave cores idle.
+
+#ifdef _WIN32
+typedef HANDLE SweepThread;
+typedef CRITICAL_SECTION SweepMutex;
+#define sweep_mutex_init(m) InitializeCriticalSection(m)
+#define sweep_mutex_lock(m) EnterCriticalSection(m)
+#define sweep_mutex_unlock(m) LeaveCriticalSection(m)
+#define sweep_mutex_destroy(m) DeleteCriticalSection(m)
+#else
+typedef pthread_t SweepThread;
+typedef pthread_mutex_t SweepMutex;
+#define sweep_mutex_init(m) pthread_mutex_init(m, NULL)
+#define sweep_mutex_lock(m) pthread_mutex_lock(m)
+#define sweep_mutex_unlock(m) pthread_mutex_unlock(m)
+#define sweep_mutex_destroy(m) pthread_mutex_destroy(m)
+#endif
+
+// Configurations [next, end) still owned by one worker
+typedef struct
+{
+    SweepMutex lock;
+    int next;
+    int end;
+} SweepDeque;
+
+typedef struct
+{
+    const Process *processes;
+    int n;
+    const SweepConfig *configs;
+    SweepResult *results;
+    SweepDeque *deques;
+    int workers;
+} SweepShared;
+
+typedef struct
+{
+    SweepShared *shared;
+    int id;
+} SweepWorker;
+
+// Each configuration keeps a MetricsAccumulator, never the finished processes
+static void sweep_record_completion(void *context, const Process *process, int seq)
+{
+    (void)seq;
+    metrics_accumulator_add((MetricsAccumulator *)context, process);
+}
+
+// Number of worker threads to use when none is requested (one per online CPU)
+int default_sweep_threads(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cpus = (int)info.dwNumberOfProcessors;
+#else
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cpus < 1)
+        cpus = 1;
+    return cpus > MAX_SWEEP_THREADS ? MAX_SWEEP_THREADS : cpus;
+}
+
+// Run the configuration's engine over source
+static int run_sweep_engine(ProcessSource *source, const SweepConfig *config, const ScheduleListener *listener)
+{
+    switch (config->algorithm)
+    {
+    case ALG_ROUND_ROBIN:
+        return round_robin_engine(source, config->quantum, listener);
+    case ALG_AGING:
+        return aging_engine(source, &config->weights, config->aging_selection, listener);
+    case ALG_SJF:
+        return sjf_engine(source, listener);
+    case ALG_SRTF:
+        return srtf_engine(source, listener);
+    case ALG_PRIORITY:
+        return priority_engine(source, listener);
+    case ALG_MLFQ:
+        return mlfq_engine(source, &config->mlfq, listener);
+    }
+    return 0;
+}
+
+// Run one configuration over an arrival-sorted table without modifying it
+// Tracing should be off (trace_level = TRACE_NONE) when called from several threads
+void run_sweep_config(const Process processes[], int n, const SweepConfig *config, SweepResult *result)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    GanttSink gantt;
+    MetricsAccumulator accumulator;
+    ScheduleMetrics metrics;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    gantt_sink_init_summary(&gantt);
+    gantt.switch_cost = config->switch_cost;
+    metrics_accumulator_init(&accumulator);
+    listener.gantt = &gantt;
+    listener.on_complete = sweep_record_completion;
+    listener.context = &accumulator;
+    listener.snapshots = NULL;
+
+    int peak_jobs = run_sweep_engine(&source, config, &listener);
+
+    SimTime total_time = gantt.blocks > 0 ? gantt.last_end - gantt.first_start : 0;
+    metrics_accumulator_finish(&accumulator, &metrics);
+    result->processes = metrics.processes;
+    result->avg_waiting = (float)metrics.waiting.mean;
+    result->avg_turnaround = (float)metrics.turnaround.mean;
+    result->avg_response = (float)metrics.response.mean;
+    result->p99_turnaround = metrics.turnaround.p99;
+    result->cpu_utilization = total_time > 0 ? ((float)(total_time - gantt.idle_time - gantt.switch_time) / total_time) * 100.0f : 0.0f;
+    result->switches = gantt.switches;
+    result->switch_overhead = total_time > 0 ? ((float)gantt.switch_time / total_time) * 100.0f : 0.0f;
+    result->peak_jobs = peak_jobs;
+}
+
+// Take the next configuration: own slice first, then steal from the fullest other slice
+// Returns -1 once every slice is empty (no work is ever added after the start)
+static int sweep_next_config(SweepShared *shared, int self)
+{
+    SweepDeque *own = &shared->deques[self];
+    int index = -1;
+
+    sweep_mutex_lock(&own->lock);
+    if (own->next < own->end)
+        index = own->next++;
+    sweep_mutex_unlock(&own->lock);
+
+    while (index < 0)
+    {
+        int victim = -1;
+        int most = 0;
+        for (int i = 0; i < shared->workers; i++)
+        {
+            if (i == self)
+                continue;
+            sweep_mutex_lock(&shared->deques[i].lock);
+            int left = shared->deques[i].end - shared->deques[i].next;
+            sweep_mutex_unlock(&shared->deques[i].lock);
+            if (left > most)
+            {
+                most = left;
+                victim = i;
+            }
+        }
+        if (victim < 0)
+            return -1;
+
+        // The victim may have drained meanwhile; then look again
+        SweepDeque *other = &shared->deques[victim];
+        sweep_mutex_lock(&other->lock);
+        if (other->next < other->end)
+            index = --other->end;
+        sweep_mutex_unlock(&other->lock);
+    }
+
+    return index;
+}
+
+// Each worker keeps one scratch arena for all its runs, so once it has
+// served its largest configuration it allocates nothing more
+static void sweep_worker(SweepWorker *worker)
+{
+    SweepShared *shared = worker->shared;
+    ScratchArena arena;
+    int index;
+
+    scratch_arena_init(&arena);
+    ScratchArena *previous = scratch_arena_activate(&arena);
+    while ((index = sweep_next_config(shared, worker->id)) >= 0)
+    {
+        scratch_arena_reset(&arena);
+        run_sweep_config(shared->processes, shared->n, &shared->configs[index], &shared->results[index]);
+    }
+    scratch_arena_activate(previous);
+    scratch_arena_free(&arena);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI sweep_worker_entry(LPVOID arg)
+{
+    sweep_worker((SweepWorker *)arg);
+    return 0;
+}
+#else
+static void *sweep_worker_entry(void *arg)
+{
+    sweep_worker((SweepWorker *)arg);
+    return NULL;
+}
+#endif
+
+// Run every configuration over the arrival-sorted table on `threads` workers
+// (<= 0 = default_sweep_threads()). results[i] receives the metrics for configs[i].
+// Scheduler tracing is switched off for the duration of the sweep.
+// Returns 0 on success, -1 if the workers could not be set up
+int run_sweep(const Process processes[], int n, const SweepConfig configs[], SweepResult results[],
+              int config_count, int threads)
+{
+    if (threads <= 0)
+        threads = default_sweep_threads();
+    if (threads > MAX_SWEEP_THREADS)
+        threads = MAX_SWEEP_THREADS;
+    if (threads > config_count)
+        threads = config_count > 0 ? config_count : 1;
+
+    SweepDeque *deques = (SweepDeque *)malloc((size_t)threads * sizeof(SweepDeque));
+    SweepWorker *workers = (SweepWorker *)malloc((size_t)threads * sizeof(SweepWorker));
+    SweepThread *handles = (SweepThread *)malloc((size_t)threads * sizeof(SweepThread));
+    if (deques == NULL || workers == NULL || handles == NULL)
+    {
+        printf("Error: Could not allocate %d sweep workers\n", threads);
+        free(deques);
+        free(workers);
+        free(handles);
+        return -1;
+    }
+
+    SweepShared shared;
+    shared.processes = processes;
+    shared.n = n;
+    shared.configs = configs;
+    shared.results = results;
+    shared.deques = deques;
+    shared.workers = threads;
+
+    for (int i = 0; i < threads; i++)
+    {
+        sweep_mutex_init(&deques[i].lock);
+        deques[i].next = (int)((long long)config_count * i / threads);
+        deques[i].end = (int)((long long)config_count * (i + 1) / threads);
+        workers[i].shared = &shared;
+        workers[i].id = i;
+    }
+
+    int saved_trace_level = trace_level;
+    trace_level = TRACE_NONE;
+
+    // Worker 0 is the calling thread; a worker that fails to start just leaves
+    // its slice to be stolen by the others
+    int started = 0;
+    for (int i = 1; i < threads; i++)
+    {
+#ifdef _WIN32
+        handles[i] = CreateThread(NULL, 0, sweep_worker_entry, &workers[i], 0, NULL);
+        int ok = handles[i] != NULL;
+#else
+        int ok = pthread_create(&handles[i], NULL, sweep_worker_entry, &workers[i]) == 0;
+#endif
+        if (!ok)
+            break;
+        started = i;
+    }
+
+    sweep_worker(&workers[0]);
+
+    for (int i = 1; i <= started; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+
+    trace_level = saved_trace_level;
+
+    for (int i = 0; i < threads; i++)
+        sweep_mutex_destroy(&deques[i].lock);
+    free(deques);
+    free(workers);
+    free(handles);
+    return 0;
+}
+
+// --- Aging Weight Search ---
+// Coarse-to-fine grid search: each round runs a WEIGHT_SEARCH_POINTS^3 grid
+// around the best weights so far as one parallel sweep, then halves the grid
+// spacing. Weights are kept >= 0. Only the ratios between the weights change
+// which process is picked, so the first round spans [0, 2 * default] per
+// weight and later rounds refine within it.
+
+static float search_objective(const SweepResult *result, int objective)
+{
+    return objective == SEARCH_MIN_TURNAROUND ? result->avg_turnaround : result->avg_waiting;
+}
+
+// Find aging weights that minimise average waiting or turnaround time
+// (objective = SEARCH_MIN_*) on an arrival-sorted table. Every candidate runs
+// with base's switch cost and aging selection.
+// best/best_result receive the winner; the defaults are always evaluated, so
+// the result is never worse than default_aging_weights().
+// Returns the number of configurations evaluated, or -1 on error
+int search_aging_weights(const Process processes[], int n, const SweepConfig *base, int objective, int threads,
+                         AgingWeights *best, SweepResult *best_result)
+{
+    const int points = WEIGHT_SEARCH_POINTS;
+    const int grid = points * points * points;
+    SweepConfig *configs = (SweepConfig *)malloc((size_t)(grid + 1) * sizeof(SweepConfig));
+    SweepResult *results = (SweepResult *)malloc((size_t)(grid + 1) * sizeof(SweepResult));
+    if (configs == NULL || results == NULL)
+    {
+        printf("Error: Could not allocate weight search grid\n");
+        free(configs);
+        free(results);
+        return -1;
+    }
+
+    AgingWeights center, step;
+    default_aging_weights(&center);
+    step.aging = 2.0 * center.aging / (points - 1);
+    step.burst = 2.0 * center.burst / (points - 1);
+    step.priority = 2.0 * center.priority / (points - 1);
+
+    // Round 0 also evaluates the defaults as the starting best
+    configs[0] = *base;
+    configs[0].algorithm = ALG_AGING;
+    configs[0].quantum = 0;
+    configs[0].weights = center;
+    if (run_sweep(processes, n, configs, results, 1, 1) != 0)
+    {
+        free(configs);
+        free(results);
+        return -1;
+    }
+    *best = center;
+    *best_result = results[0];
+    int evaluated = 1;
+
+    for (int round = 0; round < WEIGHT_SEARCH_ROUNDS; round++)
+    {
+        // Grid anchored on [0, 2 * default] in round 0, centred on the best afterwards
+        AgingWeights low;
+        low.aging = round == 0 ? 0.0 : best->aging - step.aging * (points / 2);
+        low.burst = round == 0 ? 0.0 : best->burst - step.burst * (points / 2);
+        low.priority = round == 0 ? 0.0 : best->priority - step.priority * (points / 2);
+
+        int count = 0;
+        for (int a = 0; a < points; a++)
+        {
+            for (int b = 0; b < points; b++)
+            {
+                for (int p = 0; p < points; p++)
+                {
+                    AgingWeights w;
+                    w.aging = low.aging + a * step.aging;
+                    w.burst = low.burst + b * step.burst;
+                    w.priority = low.priority + p * step.priority;
+                    if (w.aging < 0.0 || w.burst < 0.0 || w.priority < 0.0)
+                        continue;
+                    configs[count] = *base;
+                    configs[count].algorithm = ALG_AGING;
+                    configs[count].quantum = 0;
+                    configs[count].weights = w;
+                    count++;
+                }
+            }
+        }
+
+        if (run_sweep(processes, n, configs, results, count, threads) != 0)
+        {
+            free(configs);
+            free(results);
+            return -1;
+        }
+        evaluated += count;
+
+        // Strictly better only, so ties keep the earlier (simpler) weights
+        for (int i = 0; i < count; i++)
+        {
+            if (search_objective(&results[i], objective) < search_objective(best_result, objective))
+            {
+                *best = configs[i].weights;
+                *best_result = results[i];
+            }
+        }
+
+        step.aging /= 2.0;
+        step.burst /= 2.0;
+        step.priority /= 2.0;
+    }
+
+    free(configs);
+    free(results);
+    return evaluated;
+}
+
+// ============================================
+// DISTRIBUTED SWEEPS
+// ============================================
+// One sweep shared by any number of worker processes, on any number of
+// machines, through a directory they can all see. The coordinator writes the
+// plan (SWEEP_PLAN_FILE: trace, settings and every configuration), cut into
+// batches of batch_size consecutive configurations. A worker claims a batch by
+// creating batch-N.claim, which only one process can do, runs it with
+// run_sweep on all its cores and publishes the metrics as batch-N.res
+// (SweepResultRecord entries), renamed into place once complete. The
+// coordinator works batches too, then waits for the ones others hold and
+// merges every result file back into plan order.
+//
+// The plan carries a digest of the trace, so a worker whose copy differs
+// refuses to run. A worker that dies leaves a claim with no result: once the
+// coordinator has seen a claim go unpublished for claim_timeout seconds it
+// deletes it and runs the batch itself (deleting a .claim file by hand does
+// the same at once). A slow worker that still publishes afterwards writes the
+// same results, so whichever copy lands last is kept.
+
+// work_dir/name, or work_dir/batch-N.ext
+static void sweep_path(char *out, size_t size, const char *dir, const char *name, int batch)
+{
+    if (batch < 0)
+        snprintf(out, size, "%s/%s", dir, name);
+    else
+        snprintf(out, size, "%s/batch-%06d.%s", dir, batch, name);
+}
+
+// Create `path` only if it does not exist yet
+// Returns 1 if this call created it, 0 if it already existed, -1 on error
+static int create_exclusive(const char *path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return GetLastError() == ERROR_FILE_EXISTS ? 0 : -1;
+    CloseHandle(file);
+#else
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+        return errno == EEXIST ? 0 : -1;
+    close(fd);
+#endif
+    return 1;
+}
+
+// Pause between polls of the work directory
+void sweep_sleep(int seconds)
+{
+#ifdef _WIN32
+    Sleep((DWORD)seconds * 1000);
+#else
+    sleep((unsigned)seconds);
+#endif
+}
+
+// Describe a sweep of configs[] over processes[], loaded from `trace`
+// (resolved to an absolute path so workers started elsewhere find it). The
+// plan points at configs; it does not copy them.
+// Returns 0 on success, -1 if the trace path could not be resolved
+int sweep_plan_init(SweepPlan *plan, const char *trace, const Process processes[], int n, SweepConfig configs[],
+                    int config_count, int batch_size)
+{
+#ifdef _WIN32
+    int ok = _fullpath(plan->trace, trace, sizeof(plan->trace)) != NULL;
+#else
+    char *resolved = realpath(trace, NULL);
+    int ok = resolved != NULL && strlen(resolved) < sizeof(plan->trace);
+    if (ok)
+        strcpy(plan->trace, resolved);
+    free(resolved);
+#endif
+    if (!ok)
+    {
+        printf("Error: Could not resolve the path of '%s'\n", trace);
+        return -1;
+    }
+    plan->processes = n;
+    plan->digest = process_table_digest(processes, n);
+    plan->config_count = config_count;
+    plan->batch_size = batch_size > 0 ? batch_size : SWEEP_DEFAULT_BATCH;
+    plan->configs = configs;
+    return 0;
+}
+
+int sweep_plan_batches(const SweepPlan *plan)
+{
+    return (plan->config_count + plan->batch_size - 1) / plan->batch_size;
+}
+
+// One "config ..." line (plans and golden files)
+static void write_sweep_config(FILE *file, const SweepConfig *config)
+{
+    // %.17g: weights read back bit for bit, so every reader scores alike
+    fprintf(file, "config %d %d %d %d %.17g %.17g %.17g %d %d", config->algorithm, config->quantum,
+            config->switch_cost, config->aging_selection, config->weights.aging, config->weights.burst,
+            config->weights.priority, config->mlfq.boost_interval, config->mlfq.levels);
+    for (int level = 0; level < config->mlfq.levels; level++)
+        fprintf(file, " %d", config->mlfq.quanta[level]);
+    fprintf(file, "\n");
+}
+
+// Parse one "config ..." line
+static int parse_sweep_config(const char *line, SweepConfig *config)
+{
+    int used = 0;
+    MlfqConfig *mlfq = &config->mlfq;
+    if (sscanf(line, "config %d %d %d %d %lf %lf %lf %d %d%n", &config->algorithm, &config->quantum,
+               &config->switch_cost, &config->aging_selection, &config->weights.aging, &config->weights.burst,
+               &config->weights.priority, &mlfq->boost_interval, &mlfq->levels, &used) != 9 ||
+        config->algorithm < 1 || config->algorithm > ALG_COUNT || config->switch_cost < 0 ||
+        (config->aging_selection != AGING_SELECT_HEAP && config->aging_selection != AGING_SELECT_SCAN) ||
+        mlfq->levels < 0 || mlfq->levels > MLFQ_MAX_LEVELS)
+        return -1;
+    for (int level = 0; level < mlfq->levels; level++)
+    {
+        int step = 0;
+        if (sscanf(line + used, " %d%n", &mlfq->quanta[level], &step) != 1)
+            return -1;
+        used += step;
+    }
+    return 0;
+}
+
+// Publish the plan in dir (written aside and renamed, so a worker never reads half of it)
+// Returns 0 on success, -1 if dir already holds a plan or the plan could not be written
+int sweep_plan_write(const char *dir, const SweepPlan *plan)
+{
+    char path[SWEEP_PATH_MAX + 64];
+    char part[SWEEP_PATH_MAX + 64];
+    sweep_path(path, sizeof(path), dir, SWEEP_PLAN_FILE, -1);
+    sweep_path(part, sizeof(part), dir, SWEEP_PLAN_FILE ".part", -1);
+
+    FILE *existing = fopen(path, "r");
+    if (existing != NULL)
+    {
+        fclose(existing);
+        printf("Error: '%s' already holds a sweep plan; use an empty directory\n", dir);
+        return -1;
+    }
+
+    FILE *file = fopen(part, "w");
+    if (file == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", part);
+        return -1;
+    }
+    fprintf(file, "%s %d\n", SWEEP_PLAN_MAGIC, SWEEP_PLAN_VERSION);
+    fprintf(file, "processes %d\ndigest %016llx\nconfigs %d\nbatch %d\ntrace %s\n", plan->processes,
+            (unsigned long long)plan->digest, plan->config_count, plan->batch_size, plan->trace);
+    for (int i = 0; i < plan->config_count; i++)
+        write_sweep_config(file, &plan->configs[i]);
+
+    int ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(part, path) != 0)
+    {
+        printf("Error: Could not write sweep plan '%s'\n", path);
+        remove(part);
+        return -1;
+    }
+    return 0;
+}
+
+// Read the plan in dir; plan->configs is allocated (free with sweep_plan_free)
+// Returns 0 on success, 1 if dir holds no plan (yet), -1 if the plan is invalid
+int sweep_plan_read(const char *dir, SweepPlan *plan)
+{
+    char path[SWEEP_PATH_MAX + 64];
+    sweep_path(path, sizeof(path), dir, SWEEP_PLAN_FILE, -1);
+    plan->configs = NULL;
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+        return 1;
+
+    char line[SWEEP_PATH_MAX + 64];
+    char magic[16];
+    int version = 0;
+    int ok = fgets(line, sizeof(line), file) != NULL && sscanf(line, "%15s %d", magic, &version) == 2 &&
+             strcmp(magic, SWEEP_PLAN_MAGIC) == 0 && version == SWEEP_PLAN_VERSION;
+    unsigned long long digest = 0;
+    ok = ok && fscanf(file, "processes %d\ndigest %llx\nconfigs %d\nbatch %d\n", &plan->processes, &digest,
+                      &plan->config_count, &plan->batch_size) == 4;
+    plan->digest = digest;
+    ok = ok && plan->config_count > 0 && plan->batch_size > 0 && fgets(line, sizeof(line), file) != NULL &&
+         strncmp(line, "trace ", 6) == 0;
+    if (ok)
+        line[strcspn(line, "\r\n")] = '\0';
+    ok = ok && strlen(line + 6) < sizeof(plan->trace);
+    if (ok)
+    {
+        strcpy(plan->trace, line + 6);
+        plan->configs = (SweepConfig *)malloc((size_t)plan->config_count * sizeof(SweepConfig));
+        ok = plan->configs != NULL;
+    }
+    for (int i = 0; ok && i < plan->config_count; i++)
+        ok = fgets(line, sizeof(line), file) != NULL && parse_sweep_config(line, &plan->configs[i]) == 0;
+    fclose(file);
+
+    if (!ok)
+    {
+        printf("Error: '%s' is not a valid sweep plan\n", path);
+        sweep_plan_free(plan);
+        return -1;
+    }
+    return 0;
+}
+
+void sweep_plan_free(SweepPlan *plan)
+{
+    free(plan->configs);
+    plan->configs = NULL;
+}
+
+// Publish one finished batch as batch-N.res. It is written to a part file
+// named after this process, so two processes that ran the same batch (see
+// coordinate_sweep) never write into one file.
+static int sweep_write_batch(const char *dir, int batch, int first, const SweepResult results[], int count)
+{
+    char path[SWEEP_PATH_MAX + 64];
+    char part[SWEEP_PATH_MAX + 64];
+    char part_name[32];
+#ifdef _WIN32
+    snprintf(part_name, sizeof(part_name), "part-%lu", (unsigned long)GetCurrentProcessId());
+#else
+    snprintf(part_name, sizeof(part_name), "part-%ld", (long)getpid());
+#endif
+    sweep_path(path, sizeof(path), dir, "res", batch);
+    sweep_path(part, sizeof(part), dir, part_name, batch);
+
+    FILE *file = fopen(part, "wb");
+    if (file == NULL)
+    {
+        printf("Error: Could not create file '%s'\n", part);
+        return -1;
+    }
+
+    SweepResultHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SWEEP_RESULT_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(SweepResultRecord);
+    header.byte_order = SWEEP_BYTE_ORDER;
+    header.batch = batch;
+    header.first = first;
+    header.count = count;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; ok && i < count; i++)
+    {
+        SweepResultRecord record;
+        record.p99_turnaround = results[i].p99_turnaround;
+        record.processes = results[i].processes;
+        record.switches = results[i].switches;
+        record.peak_jobs = results[i].peak_jobs;
+        record.avg_waiting = results[i].avg_waiting;
+        record.avg_turnaround = results[i].avg_turnaround;
+        record.avg_response = results[i].avg_response;
+        record.cpu_utilization = results[i].cpu_utilization;
+        record.switch_overhead = results[i].switch_overhead;
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    ok = fclose(file) == 0 && ok;
+    // rename() does not replace an existing file on Windows; one already
+    // published by another process that ran the batch holds the same results
+    int renamed = ok && rename(part, path) == 0;
+    int published = renamed;
+    if (!renamed && ok && (file = fopen(path, "rb")) != NULL)
+    {
+        fclose(file);
+        published = 1;
+    }
+    if (!renamed)
+        remove(part);
+    if (!published)
+    {
+        printf("Error: Could not write batch results '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Claim and run batches of the plan until none is left unclaimed. A batch
+// that fails is unclaimed again.
+// Returns the number of batches this call ran, or -1 on error
+int sweep_work_batches(const char *dir, const SweepPlan *plan, const Process processes[], int n, int threads)
+{
+    SweepResult *results = (SweepResult *)malloc((size_t)plan->batch_size * sizeof(SweepResult));
+    if (results == NULL)
+    {
+        printf("Error: Could not allocate %d sweep results\n", plan->batch_size);
+        return -1;
+    }
+
+    int ran = 0;
+    int batches = sweep_plan_batches(plan);
+    for (int batch = 0; batch < batches && ran >= 0; batch++)
+    {
+        char claim[SWEEP_PATH_MAX + 64];
+        sweep_path(claim, sizeof(claim), dir, "claim", batch);
+        int claimed = create_exclusive(claim);
+        if (claimed < 0)
+        {
+            printf("Error: Could not create file '%s'\n", claim);
+            ran = -1;
+        }
+        if (claimed <= 0)
+            continue;
+
+        int first = batch * plan->batch_size;
+        int count = plan->config_count - first < plan->batch_size ? plan->config_count - first : plan->batch_size;
+        if (run_sweep(processes, n, plan->configs + first, results, count, threads) != 0 ||
+            sweep_write_batch(dir, batch, first, results, count) != 0)
+        {
+            remove(claim);
+            ran = -1;
+        }
+        else
+            ran++;
+    }
+
+    free(results);
+    return ran;
+}
+
+// Read every published batch not yet marked in done[] (one flag per batch)
+// into results[] at its plan index
+// Returns the number of batches still unpublished, or -1 if a result file is invalid
+int sweep_collect_results(const char *dir, const SweepPlan *plan, SweepResult results[], char done[])
+{
+    int left = 0;
+    int batches = sweep_plan_batches(plan);
+    for (int batch = 0; batch < batches; batch++)
+    {
+        if (done[batch])
+            continue;
+
+        char path[SWEEP_PATH_MAX + 64];
+        sweep_path(path, sizeof(path), dir, "res", batch);
+        FILE *file = fopen(path, "rb");
+        if (file == NULL)
+        {
+            left++;
+            continue;
+        }
+
+        int first = batch * plan->batch_size;
+        int count = plan->config_count - first < plan->batch_size ? plan->config_count - first : plan->batch_size;
+        SweepResultHeader header;
+        int ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, SWEEP_RESULT_MAGIC, sizeof(header.magic)) == 0;
+        int foreign = ok && header.byte_order != SWEEP_BYTE_ORDER;
+        ok = ok && !foreign && header.record_size == sizeof(SweepResultRecord) && header.batch == batch &&
+             header.first == first && header.count == count;
+        for (int i = 0; ok && i < count; i++)
+        {
+            SweepResultRecord record;
+            ok = fread(&record, sizeof(record), 1, file) == 1;
+            SweepResult *result = &results[first + i];
+            result->processes = record.processes;
+            result->avg_waiting = record.avg_waiting;
+            result->avg_turnaround = record.avg_turnaround;
+            result->avg_response = record.avg_response;
+            result->p99_turnaround = record.p99_turnaround;
+            result->cpu_utilization = record.cpu_utilization;
+            result->switches = record.switches;
+            result->switch_overhead = record.switch_overhead;
+            result->peak_jobs = record.peak_jobs;
+        }
+        fclose(file);
+        if (!ok)
+        {
+            printf(foreign ? "Error: '%s' was written on a machine with a different byte order\n"
+                           : "Error: '%s' is not a valid batch result for this plan\n",
+                   path);
+            return -1;
+        }
+        done[batch] = 1;
+    }
+    return left;
+}
+
+// Give back every claim the coordinator has seen unpublished for longer than
+// claim_timeout seconds; since[batch] is when it first saw the claim (0 = not seen)
+static void sweep_expire_claims(const char *dir, const SweepPlan *plan, const char done[], double since[],
+                                int claim_timeout, int verbose)
+{
+    double now = benchmark_clock();
+    int batches = sweep_plan_batches(plan);
+    for (int batch = 0; batch < batches; batch++)
+    {
+        char claim[SWEEP_PATH_MAX + 64];
+        sweep_path(claim, sizeof(claim), dir, "claim", batch);
+        FILE *file = done[batch] ? NULL : fopen(claim, "r");
+        if (file == NULL)
+        {
+            since[batch] = 0.0;
+            continue;
+        }
+        fclose(file);
+        if (since[batch] == 0.0)
+            since[batch] = now;
+        else if (now - since[batch] > claim_timeout && remove(claim) == 0)
+        {
+            if (verbose)
+                printf("Batch %d has been claimed for over %d seconds without a result; running it again\n", batch,
+                       claim_timeout);
+            since[batch] = 0.0;
+        }
+    }
+}
+
+// Coordinator: publish the plan, work batches alongside the other workers,
+// then wait for the batches they hold, running again any batch whose claim
+// stays unpublished for claim_timeout seconds (0 = wait for ever).
+// results[i] receives the metrics for plan->configs[i], exactly as run_sweep
+// would have.
+// Returns 0 on success, -1 on error
+int coordinate_sweep(const char *dir, const SweepPlan *plan, const Process processes[], int n,
+                     SweepResult results[], int threads, int claim_timeout, int verbose)
+{
+    int batches = sweep_plan_batches(plan);
+    char *done = (char *)calloc((size_t)batches, 1);
+    double *since = (double *)calloc((size_t)batches, sizeof(double));
+    if (done == NULL || since == NULL || sweep_plan_write(dir, plan) != 0)
+    {
+        free(done);
+        free(since);
+        return -1;
+    }
+    if (verbose)
+        printf("Sharing %d configurations in %d batches through '%s'\n", plan->config_count, batches, dir);
+
+    int status = -1;
+    int waiting = 0;
+    while (1)
+    {
+        // Run anything unclaimed (including batches a failed worker gave back)
+        int ran = sweep_work_batches(dir, plan, processes, n, threads);
+        int left = ran < 0 ? -1 : sweep_collect_results(dir, plan, results, done);
+        if (left <= 0)
+        {
+            status = left;
+            break;
+        }
+        if (verbose && !waiting)
+        {
+            printf("Waiting for %d batches held by other workers\n", left);
+            fflush(stdout);
+        }
+        waiting = 1;
+        if (claim_timeout > 0)
+            sweep_expire_claims(dir, plan, done, since, claim_timeout, verbose);
+        sweep_sleep(SWEEP_POLL_SECONDS);
+    }
+
+    free(done);
+    free(since);
+    return status;
+}
+
+// ============================================
+// INCREMENTAL RE-SIMULATION
+// ============================================
+// A recorded run keeps a snapshot (EngineSnapshot) at the first quiescent
+// point after every `interval` of simulated time. When the table is edited,
+// the run up to a snapshot is unchanged as long as every process it consumed
+// is unchanged and the first edited process arrives after the snapshot: the
+// engine never looked at that one, except to see that it arrives later. So
+// resimulate() copies the results and Gantt blocks up to the latest such
+// snapshot and lets the engine pick up from there, replaying only the tail.
+
+void recorded_run_init(RecordedRun *run, SimTime snapshot_interval)
+{
+    init_process_table(&run->processes);
+    gantt_sink_init_buffer(&run->gantt, &run->chart);
+    run->snapshots.items = NULL;
+    run->snapshots.count = 0;
+    run->snapshots.capacity = 0;
+    run->snapshots.interval = snapshot_interval > 0 ? snapshot_interval : SNAPSHOT_DEFAULT_INTERVAL;
+    run->snapshots.next_due = 0;
+    run->resumed_from = -1;
+    run->reused = 0;
+}
+
+void recorded_run_free(RecordedRun *run)
+{
+    free_process_table(&run->processes);
+    gantt_buffer_free(&run->chart);
+    free(run->snapshots.items);
+    recorded_run_init(run, run->snapshots.interval);
+}
+
+// Index of the first process whose input (pid, arrival, burst, priority)
+// differs between the tables; the shorter length if one is a prefix of the other
+int first_changed_process(const Process a[], int a_count, const Process b[], int b_count)
+{
+    int count = a_count < b_count ? a_count : b_count;
+    for (int i = 0; i < count; i++)
+    {
+        if (a[i].pid != b[i].pid || a[i].arrival_time != b[i].arrival_time ||
+            a[i].burst_time != b[i].burst_time || a[i].priority != b[i].priority)
+            return i;
+    }
+    return count;
+}
+
+// Latest snapshot of base that is still valid for processes[] (-1 = none)
+static int find_resume_snapshot(const RecordedRun *base, const Process processes[], int n)
+{
+    const SnapshotLog *log = &base->snapshots;
+    int changed = first_changed_process(base->processes.items, base->processes.count, processes, n);
+
+    // Both conditions only get harder to meet as snapshots get later, so the
+    // valid ones are a prefix of the log
+    int low = 0;
+    int high = log->count; // items[low, high) not yet decided
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        const EngineSnapshot *snapshot = &log->items[mid];
+        int valid = snapshot->taken <= changed &&
+                    (changed >= base->processes.count ||
+                     snapshot->time < base->processes.items[changed].arrival_time) &&
+                    (changed >= n || snapshot->time < processes[changed].arrival_time);
+        if (valid)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low - 1;
+}
+
+// Run config over processes[] into run, starting from base's snapshot `resume` (-1 = time 0)
+static int recorded_run_start(const RecordedRun *base, int resume, const Process processes[], int n,
+                              const SweepConfig *config, RecordedRun *run)
+{
+    const EngineSnapshot *snapshot = resume >= 0 ? &base->snapshots.items[resume] : NULL;
+    int reused = snapshot != NULL ? snapshot->taken : 0;
+    int blocks = snapshot != NULL ? snapshot->totals.blocks : 0;
+
+    if (reserve_process_table(&run->processes, n) != 0)
+        return -1;
+    run->config = *config;
+    run->processes.count = n;
+    run->resumed_from = resume;
+    run->reused = reused;
+
+    // Everything up to the snapshot is the base run's: results, blocks, snapshots
+    memcpy(run->processes.items, base != NULL ? base->processes.items : processes, (size_t)reused * sizeof(Process));
+    memcpy(run->processes.items + reused, processes + reused, (size_t)(n - reused) * sizeof(Process));
+    reset_processes(run->processes.items + reused, n - reused);
+
+    if (blocks > run->chart.capacity)
+    {
+        run->chart.blocks = (GanttBlock *)checked_realloc(run->chart.blocks, (size_t)blocks * sizeof(GanttBlock));
+        run->chart.capacity = blocks;
+    }
+    if (blocks > 0)
+        memcpy(run->chart.blocks, base->chart.blocks, (size_t)blocks * sizeof(GanttBlock));
+    run->chart.size = blocks;
+    gantt_sink_init_summary(&run->gantt);
+    if (snapshot != NULL)
+        run->gantt = snapshot->totals;
+    run->gantt.write = gantt_buffer_write;
+    run->gantt.context = &run->chart;
+    run->gantt.switch_cost = config->switch_cost;
+
+    SnapshotLog *log = &run->snapshots;
+    int kept = resume + 1;
+    if (base != NULL)
+        log->interval = base->snapshots.interval;
+    if (kept > log->capacity)
+    {
+        log->items = (EngineSnapshot *)checked_realloc(log->items, (size_t)kept * sizeof(EngineSnapshot));
+        log->capacity = kept;
+    }
+    if (kept > 0)
+        memcpy(log->items, base->snapshots.items, (size_t)kept * sizeof(EngineSnapshot));
+    log->count = kept;
+    log->next_due = snapshot != NULL ? snapshot->time - snapshot->time % log->interval + log->interval : 0;
+
+    ProcessSource source;
+    ArraySourceContext source_context;
+    ScheduleListener listener;
+    process_source_init_array(&source, &source_context, run->processes.items + reused, n - reused);
+    source.taken = reused; // Sequence numbers stay indices into the whole table
+    source.resume = snapshot;
+    array_listener_init(&listener, run->processes.items, &run->gantt);
+    listener.snapshots = log;
+
+    run_sweep_engine(&source, config, &listener);
+    return reused;
+}
+
+// Run config (single CPU) over an arrival-sorted table from time 0, keeping
+// results, the Gantt chart and snapshots in run. Returns 0, or -1 on error.
+int record_run(const Process processes[], int n, const SweepConfig *config, RecordedRun *run)
+{
+    return recorded_run_start(NULL, -1, processes, n, config, run) < 0 ? -1 : 0;
+}
+
+// Re-run base's configuration over processes[], an edited copy of base's
+// table (arrival-sorted). The result is the same as record_run() would give,
+// but only the part after the latest valid snapshot is simulated (run takes
+// base's snapshot interval). Returns the number of processes whose results
+// were reused, or -1 on error.
+int resimulate(const RecordedRun *base, const Process processes[], int n, RecordedRun *run)
+{
+    int resume = find_resume_snapshot(base, processes, n);
+    return recorded_run_start(base, resume, processes, n, &base->config, run);
+}
+
+// ============================================
+// SYNTHETIC WORKLOADS & BENCHMARKING
+// ============================================
+
+void default_workload_config(WorkloadConfig *config, int count)
+{
+    config->count = count;
+    config->arrival_rate = WORKLOAD_ARRIVAL_RATE;
+    config->burst_shape = WORKLOAD_BURST_SHAPE;
+    config->burst_min = WORKLOAD_BURST_MIN;
+    config->burst_max = WORKLOAD_BURST_MAX;
+    config->idle_chance = WORKLOAD_IDLE_CHANCE;
+    config->idle_gap_max = WORKLOAD_IDLE_GAP_MAX;
+    config->priorities = WORKLOAD_PRIORITIES;
+    config->seed = 1;
+}
+
+// splitmix64: small, fast, and the same sequence everywhere (unlike rand())
+static uint64_t workload_next(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1], so log() and pow() never see zero
+static double workload_uniform(uint64_t *state)
+{
+    return ((double)(workload_next(state) >> 11) + 1.0) / 9007199254740992.0; // 2^53
+}
+
+// Fill the table with config->count arrival-sorted processes
+// Returns the number generated, or -1 if the table can't hold them or the
+// arrivals would run past the range of SimTime
+int generate_workload(const WorkloadConfig *config, ProcessTable *table)
+{
+    if (reserve_process_table(table, config->count > 0 ? config->count : 1) != 0)
+        return -1;
+
+    uint64_t state = config->seed;
+    double clock = 0.0;
+    double inverse_shape = 1.0 / config->burst_shape;
+
+    for (int i = 0; i < config->count; i++)
+    {
+        // Exponential gaps between arrivals make a Poisson process
+        clock += -log(workload_uniform(&state)) / config->arrival_rate;
+        if (workload_uniform(&state) < config->idle_chance)
+            clock += 1.0 + (double)(workload_next(&state) % (uint64_t)config->idle_gap_max);
+        if (clock >= (double)INT64_MAX)
+        {
+            printf("Error: Generated arrivals overflow after %d processes\n", i);
+            return -1;
+        }
+
+        double burst = config->burst_min / pow(workload_uniform(&state), inverse_shape);
+        if (burst > config->burst_max)
+            burst = config->burst_max;
+        int priority = 1 + (int)(workload_next(&state) % (uint64_t)config->priorities);
+
+        init_process(&table->items[i], i + 1, (SimTime)clock, (SimTime)burst, priority);
+    }
+
+    table->count = config->count;
+    return config->count;
+}
+
+// Seconds from an arbitrary start, with sub-microsecond resolution
+double benchmark_clock(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+// ============================================
+// GOLDEN RUNS
+// ============================================
+// A golden file fingerprints runs known to be right so that a change to the
+// engines can be checked against them (--golden-write, --golden-check). A case
+// is one configuration over one trace: a file, or a seeded generate_workload
+// trace, which is the same on every platform. Its Gantt blocks and its
+// completions, in the order they happen, are folded into 64-bit FNV-1a
+// digests, one per GOLDEN_CHUNK records, so a changed schedule is located to
+// the chunk (and time) where it first differs without storing the schedule.
+// Each case also carries a wall-clock budget and a budget for the scratch
+// memory its engine allocates, which is measured per run (unlike the
+// process's peak RSS, which only ever grows) and the same on every machine.
+
+void golden_digest_init(GoldenDigest *digest)
+{
+    digest->chunks = NULL;
+    digest->times = NULL;
+    digest->chunk_count = 0;
+    digest->capacity = 0;
+    digest->records = 0;
+    digest->failed = 0;
+}
+
+void golden_digest_free(GoldenDigest *digest)
+{
+    free(digest->chunks);
+    free(digest->times);
+    golden_digest_init(digest);
+}
+
+// Fold one record into the digest; `time` is when it happened (kept per chunk for reports)
+static void golden_digest_add(GoldenDigest *digest, SimTime time, const int64_t fields[], int count)
+{
+    if (digest->failed)
+        return;
+    if (digest->records % GOLDEN_CHUNK == 0)
+    {
+        if (digest->chunk_count == digest->capacity)
+        {
+            int grown = digest->capacity > 0 ? digest->capacity * 2 : 16;
+            uint64_t *chunks = (uint64_t *)realloc(digest->chunks, (size_t)grown * sizeof(uint64_t));
+            if (chunks != NULL)
+                digest->chunks = chunks;
+            SimTime *times = (SimTime *)realloc(digest->times, (size_t)grown * sizeof(SimTime));
+            if (times != NULL)
+                digest->times = times;
+            if (chunks == NULL || times == NULL)
+            {
+                digest->failed = 1;
+                return;
+            }
+            digest->capacity = grown;
+        }
+        digest->chunks[digest->chunk_count] = FNV_OFFSET;
+        digest->times[digest->chunk_count++] = time;
+    }
+
+    uint64_t hash = digest->chunks[digest->chunk_count - 1];
+    for (int i = 0; i < count; i++)
+        hash = fnv1a_add(hash, (uint64_t)fields[i]);
+    digest->chunks[digest->chunk_count - 1] = hash;
+    digest->records++;
+}
+
+static void golden_block_write(GanttSink *sink, const GanttBlock *block)
+{
+    int64_t fields[4] = {block->pid, block->core, block->start_time, block->end_time};
+    golden_digest_add((GoldenDigest *)sink->context, block->start_time, fields, 4);
+}
+
+static void golden_record_completion(void *context, const Process *process, int seq)
+{
+    int64_t fields[4] = {process->pid, seq, process->first_run_time, process->completion_time};
+    golden_digest_add((GoldenDigest *)context, process->completion_time, fields, 4);
+}
+
+void golden_run_init(GoldenRun *run)
+{
+    golden_digest_init(&run->blocks);
+    golden_digest_init(&run->completions);
+    run->seconds = 0.0;
+    run->engine_kb = 0;
+}
+
+void golden_run_free(GoldenRun *run)
+{
+    golden_digest_free(&run->blocks);
+    golden_digest_free(&run->completions);
+}
+
+// Run one configuration over an arrival-sorted table and fingerprint it
+// (run must be freshly initialised). Tracing is off for the run.
+// Returns 0 on success, -1 if the digests could not be allocated
+int golden_run(const Process processes[], int n, const SweepConfig *config, GoldenRun *run)
+{
+    ProcessSource source;
+    ArraySourceContext source_context;
+    GanttSink gantt;
+    ScheduleListener listener;
+
+    process_source_init_array(&source, &source_context, processes, n);
+    gantt_sink_init_summary(&gantt);
+    gantt.write = golden_block_write;
+    gantt.context = &run->blocks;
+    gantt.switch_cost = config->switch_cost;
+    listener.gantt = &gantt;
+    listener.on_complete = golden_record_completion;
+    listener.context = &run->completions;
+    listener.snapshots = NULL;
+
+    // A fresh arena per run, so engine_kb counts this run's allocations only
+    ScratchArena arena;
+    scratch_arena_init(&arena);
+    ScratchArena *previous = scratch_arena_activate(&arena);
+    int saved_trace_level = trace_level;
+    trace_level = TRACE_NONE;
+    double start = benchmark_clock();
+    run_sweep_engine(&source, config, &listener);
+    run->seconds = benchmark_clock() - start;
+    trace_level = saved_trace_level;
+    run->engine_kb = (long)((scratch_arena_used(&arena) + 1023) / 1024);
+    scratch_arena_activate(previous);
+    scratch_arena_free(&arena);
+
+    if (run->blocks.failed || run->completions.failed)
+    {
+        printf("Error: Could not allocate golden digests\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Describe where two digests of the same stream first differ (`what` names the records, `unit` one of them)
+// Returns 0 if they are the same, 1 (with `why` filled in) if not
+static int golden_digest_compare(const GoldenDigest *expected, const GoldenDigest *actual, const char *what,
+                                 const char *unit, char *why, size_t size)
+{
+    int chunks = expected->chunk_count < actual->chunk_count ? expected->chunk_count : actual->chunk_count;
+    for (int i = 0; i < chunks; i++)
+    {
+        if (expected->chunks[i] != actual->chunks[i])
+        {
+            long long first = (long long)i * GOLDEN_CHUNK;
+            long long records = expected->records > actual->records ? expected->records : actual->records;
+            long long last = first + GOLDEN_CHUNK < records ? first + GOLDEN_CHUNK - 1 : records - 1;
+            snprintf(why, size, "%s first differ within %ss %lld-%lld (from time %lld)", what, unit, first, last,
+                     actual->times[i]);
+            return 1;
+        }
+    }
+    if (expected->records != actual->records)
+    {
+        snprintf(why, size, "%lld %s, golden run has %lld", actual->records, what, expected->records);
+        return 1;
+    }
+    return 0;
+}
+
+// Returns 0 if the runs have the same schedule, 1 (with `why` filled in) if not
+int golden_run_compare(const GoldenRun *expected, const GoldenRun *actual, char *why, size_t size)
+{
+    return golden_digest_compare(&expected->blocks, &actual->blocks, "Gantt blocks", "block", why, size) ||
+           golden_digest_compare(&expected->completions, &actual->completions, "completions", "completion", why,
+                                 size);
+}
+
+static void golden_digest_write(FILE *file, const char *name, const GoldenDigest *digest)
+{
+    fprintf(file, "%s %lld %d\n", name, digest->records, digest->chunk_count);
+    for (int i = 0; i < digest->chunk_count; i++)
+        fprintf(file, "%016llx\n", (unsigned long long)digest->chunks[i]);
+}
+
+// Append one case (its run's digests and its budgets) to a golden file
+void golden_case_write(FILE *file, const GoldenCase *golden)
+{
+    fprintf(file, "case\n");
+    if (golden->source[0] != '\0')
+        fprintf(file, "file %s\n", golden->source);
+    else
+        fprintf(file, "generate %d %llu\n", golden->generate, (unsigned long long)golden->seed);
+    write_sweep_config(file, &golden->config);
+    fprintf(file, "budget %.6f %ld\n", golden->budget_seconds, golden->budget_kb);
+    golden_digest_write(file, "blocks", &golden->run.blocks);
+    golden_digest_write(file, "completions", &golden->run.completions);
+    fprintf(file, "end\n");
+}
+
+static int golden_digest_read(FILE *file, const char *name, GoldenDigest *digest)
+{
+    char line[64];
+    char seen[16];
+    int chunks = 0;
+    if (fgets(line, sizeof(line), file) == NULL ||
+        sscanf(line, "%15s %lld %d", seen, &digest->records, &chunks) != 3 || strcmp(seen, name) != 0 ||
+        chunks < 0 || (long long)chunks != (digest->records + GOLDEN_CHUNK - 1) / GOLDEN_CHUNK)
+        return -1;
+
+    digest->chunks = (uint64_t *)malloc((size_t)(chunks > 0 ? chunks : 1) * sizeof(uint64_t));
+    if (digest->chunks == NULL)
+        return -1;
+    digest->capacity = chunks;
+    for (int i = 0; i < chunks; i++)
+    {
+        unsigned long long value;
+        if (fgets(line, sizeof(line), file) == NULL || sscanf(line, "%llx", &value) != 1)
+            return -1;
+        digest->chunks[digest->chunk_count++] = (uint64_t)value;
+    }
+    return 0;
+}
+
+// Read the next case of a golden file (golden->run is initialised here; free it with golden_run_free)
+// Returns 1 if a case was read, 0 at the end of the file, -1 if the file is invalid
+int golden_case_read(FILE *file, GoldenCase *golden)
+{
+    char line[SWEEP_PATH_MAX + 64];
+    golden_run_init(&golden->run);
+    if (fgets(line, sizeof(line), file) == NULL)
+        return 0;
+
+    unsigned long long seed = 0;
+    int ok = strcmp(line, "case\n") == 0 && fgets(line, sizeof(line), file) != NULL;
+    golden->source[0] = '\0';
+    golden->generate = 0;
+    if (ok && strncmp(line, "file ", 5) == 0)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        ok = line[5] != '\0' && strlen(line + 5) < sizeof(golden->source);
+        if (ok)
+            strcpy(golden->source, line + 5);
+    }
+    else
+        ok = ok && sscanf(line, "generate %d %llu", &golden->generate, &seed) == 2 && golden->generate > 0;
+    golden->seed = (uint64_t)seed;
+    ok = ok && fgets(line, sizeof(line), file) != NULL && parse_sweep_config(line, &golden->config) == 0;
+    ok = ok && fscanf(file, "budget %lf %ld\n", &golden->budget_seconds, &golden->budget_kb) == 2;
+    ok = ok && golden_digest_read(file, "blocks", &golden->run.blocks) == 0 &&
+         golden_digest_read(file, "completions", &golden->run.completions) == 0;
+    ok = ok && fgets(line, sizeof(line), file) != NULL && strcmp(line, "end\n") == 0;
+    if (!ok)
+    {
+        golden_run_free(&golden->run);
+        return -1;
+    }
+    return 1;
 }
 
 #endif // FUNCTIONS_H
@@ -13,110 +13,2185 @@
  * Input file format (CSV):
  *   PID,Arrival_Time,Burst_Time,Priority
  *   (Priority is optional)
+ *
+ * Usage:
+ *   scheduler                          interactive menu (prompts for the file)
+ *   scheduler FILE                     interactive menu on FILE
+ *   scheduler -a ALG [-q N] [-f FMT] FILE
+ *                                      batch run without any prompts
+ *   scheduler -a ALG -f csv|json FILE  the same run as CSV or JSON Lines records
+ *   scheduler --convert OUT.bin FILE   convert a CSV file to a binary trace
+ *   scheduler --sweep [-a ALG] --quanta LIST [--threads N] FILE
+ *                                      run many configurations in parallel and
+ *                                      print one metrics row per configuration
+ *   scheduler --sweep --work-dir DIR [--batch N] [--claim-timeout S] [-a ALG] --quanta LIST FILE
+ *   scheduler --sweep-worker DIR [--threads N]
+ *                                      share one sweep out to workers on any number
+ *                                      of machines through the shared directory DIR
+ *   scheduler --search-weights waiting|turnaround [--threads N] FILE
+ *                                      search for aging weights that minimise
+ *                                      average waiting or turnaround time
+ *   scheduler --stream -a ALG [-q N] FILE
+ *                                      schedule arrivals as they are read, printing
+ *                                      Gantt blocks and completions as they happen
+ *   scheduler --generate N [--seed S] OUT
+ *                                      write a synthetic N-process trace to OUT
+ *   scheduler --bench [--jobs LIST] [-a ALG] [-q N] [FILE]
+ *                                      time each engine on synthetic traces (or FILE)
+ *                                      and report jobs/sec and engine memory
+ *   scheduler --what-if EDITED -a ALG [-q N] FILE
+ *                                      re-simulate EDITED (a changed copy of FILE) from
+ *                                      the last snapshot before the first change
+ *   scheduler --golden-write GOLDEN [-a ALG] [-q N] FILE | --jobs LIST [--seed S]
+ *   scheduler --golden-check GOLDEN
+ *                                      fingerprint known-good schedules, then check that
+ *                                      the engines still produce them within budget
+ *
+ * Binary traces (see BinaryTraceHeader) are detected automatically wherever
+ * a process file is read, including menu option 6.
  */
 
-#include "functions.h"
+#include "functions.h"
+
+// ============================================
+// COMMAND LINE
+// ============================================
+#define ALGORITHM_ALL (ALG_COUNT + 1) // Batch id for the "Run All" menu entry
+
+// Menu entries 1-6 keep their original meaning; later algorithms are appended after them
+#define MENU_RUN_ALL 4
+#define MENU_DISPLAY 5
+#define MENU_RELOAD 6
+#define MENU_SRTF 7
+#define MENU_PRIORITY 8
+#define MENU_MLFQ 9
+
+#define FORMAT_TEXT 0    // Gantt chart + results table (same as the menu)
+#define FORMAT_SUMMARY 1 // One line of averages per algorithm
+#define FORMAT_CSV 2     // Run, gantt, process and summary records as CSV (ResultsWriter)
+#define FORMAT_JSON 3    // The same records as JSON Lines
+
+#define BENCH_DEFAULT_JOBS "1000,10000,100000,1000000" // Trace sizes for --bench without --jobs
+#define BENCH_DEFAULT_QUANTUM 4 // Round Robin quantum for --bench without --quantum
+#define BENCH_MIN_SECONDS 0.2   // Short runs are repeated until this much time has passed
+#define WHAT_IF_REPEATS 5       // --what-if times the best of this many replay and full runs
+
+typedef struct
+{
+    const char *input_file;    // NULL = prompt for it
+    int algorithm;             // 0 = interactive menu, ALG_* or ALGORITHM_ALL = batch run
+    int quantum;               // Round Robin quantum, 0 = prompt for it
+    int format;                // FORMAT_* (CSV and JSON skip every text table and trace line)
+    const char *convert_to;    // Binary trace to write from input_file, NULL = no conversion
+    int stream;                // Schedule while reading instead of loading the whole file
+    const char *gantt_file;    // Write Gantt blocks here as CSV instead of drawing the chart
+    const char *gantt_svg;     // Also draw the chart to this SVG (or .html) file, NULL = no
+    int stats;                 // Count engine operations and time each phase (see EngineStats)
+    int sweep;                 // Run a parallel parameter sweep instead of a single run
+    const char *quanta;        // Sweep quanta list ("1-8,16,32"), NULL = just --quantum
+    int threads;               // Sweep worker threads, 0 = one per CPU
+    const char *work_dir;      // Share the sweep out through this directory, NULL = run it all here
+    const char *sweep_worker;  // Work batches of the sweep planned in this directory, NULL = no
+    int batch;                 // Configurations per distributed batch, 0 = SWEEP_DEFAULT_BATCH
+    int claim_timeout;         // Seconds before an unpublished claim is run again, -1 = SWEEP_CLAIM_TIMEOUT
+    AgingWeights weights;      // Modified FCFS with Aging score weights
+    int search;                // SEARCH_MIN_* objective for --search-weights, -1 = no search
+    int cores;                 // Simulated CPUs (1 = the single-CPU algorithms)
+    int queues;                // QUEUE_GLOBAL or QUEUE_PER_CORE when cores > 1
+    MlfqConfig mlfq;           // MLFQ levels and boost interval
+    int switch_cost;           // Time charged per context switch (see charge_context_switch)
+    int aging_selection;       // AGING_SELECT_* for Modified FCFS with Aging
+    int generate;              // Write a synthetic trace of this many processes to input_file, 0 = no
+    int bench;                 // Time the engines instead of showing results
+    const char *jobs;          // Benchmark trace sizes ("1000,10000"), NULL = BENCH_DEFAULT_JOBS
+    uint64_t seed;             // Synthetic workload seed (--generate and --bench)
+    const char *what_if;       // Edited copy of input_file to re-simulate incrementally, NULL = no
+    SimTime snapshot_interval;    // Simulated time between snapshots for --what-if
+    const char *golden_write;  // Append golden cases for this run to this file, NULL = no
+    const char *golden_check;  // Check every case of this golden file, NULL = no
+} Options;
+
+static const char *algorithm_names[] = {"", "Round Robin", "Modified FCFS with Aging", "Shortest Job First (SJF)",
+                                        "Shortest Remaining Time First (SRTF)", "Preemptive Priority",
+                                        "Multilevel Feedback Queue (MLFQ)"};
+
+void print_usage(const char *program)
+{
+    printf("Usage: %s [options] [input_file]\n", program);
+    printf("\n");
+    printf("Without --algorithm the interactive menu is shown.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  -a, --algorithm ALG  Run ALG and exit: rr, aging, sjf, all, srtf, priority, mlfq\n");
+    printf("                       (or their menu numbers 1, 2, 3, 4, 7, 8, 9)\n");
+    printf("  -q, --quantum N      Round Robin time quantum (required for rr/all in batch mode)\n");
+    printf("  -f, --format FMT     Output format: text (default), summary, or csv / json\n");
+    printf("                       (run, gantt, process and summary records on stdout, no tables)\n");
+    printf("  -s, --stream         With --algorithm: read arrivals lazily and report events as they happen\n");
+    printf("  -g, --gantt-file OUT With --algorithm (one algorithm): write Gantt blocks to OUT as they happen\n");
+    printf("  --gantt-svg OUT      With --algorithm (one algorithm): also draw the Gantt chart to OUT (SVG, or\n");
+    printf("                       an HTML page if OUT ends in .html)\n");
+    printf("  --stats              With --algorithm: count dispatches, queue operations, candidates per pick,\n");
+    printf("                       idle jumps and Gantt merges, and time each phase (stats record in csv/json)\n");
+    printf("  --sweep              Run every (algorithm, quantum) configuration in parallel; ALG defaults to all\n");
+    printf("  --quanta LIST        Sweep quanta, e.g. 1-8,16,32 (default: --quantum)\n");
+    printf("  --threads N          Sweep worker threads (default: one per CPU)\n");
+    printf("  --work-dir DIR       With --sweep: share the configurations out in batches through DIR, a\n");
+    printf("                       directory every worker can see; work them here too and print the table\n");
+    printf("  --batch N            Configurations per --work-dir batch (default %d)\n", SWEEP_DEFAULT_BATCH);
+    printf("  --claim-timeout S    Run a --work-dir batch again if its claim has no result after S seconds\n");
+    printf("                       (default %d, 0 = wait for ever)\n", SWEEP_CLAIM_TIMEOUT);
+    printf("  --sweep-worker DIR   Run batches of the sweep planned in DIR until none is left\n");
+    printf("  -w, --weights A,B,P  Aging score weights: waiting, burst, priority (default 2.0,0.5,3.0); the\n");
+    printf("                       heap rounds scores to 1/1000, exact for multiples of 0.5 and otherwise\n");
+    printf("                       close to, not the same as, the 0.001 tie rule of --aging-select scan\n");
+    printf("  --search-weights OBJ Search for aging weights minimising OBJ: waiting or turnaround; candidates\n");
+    printf("                       run with --aging-select, so the heap's rounding applies unless it is scan\n");
+    printf("  --aging-select MODE  How aging picks a job: heap (default) or scan (compare every ready job)\n");
+    printf("  --mlfq-quanta LIST   MLFQ levels by quantum, top first (default 2,4,8)\n");
+    printf("  --boost N            MLFQ priority boost interval, 0 = never (default %d)\n", MLFQ_DEFAULT_BOOST);
+    printf("  -n, --cores N        Simulate N CPUs (default 1); charts and utilization are reported per CPU\n");
+    printf("  --queues MODE        With --cores: global (one shared ready queue, default) or per-core (work stealing)\n");
+    printf("  --switch-cost N      Time charged for each context switch, shown as CS in the Gantt chart (default 0)\n");
+    printf("  -c, --convert OUT    Convert the CSV input file to binary trace OUT and exit\n");
+    printf("  --generate N         Write a synthetic N-process trace to the input file name (.bin = binary) and exit;\n");
+    printf("                       an existing file is never overwritten\n");
+    printf("  --bench              Time each engine on synthetic traces (or the input file): jobs/sec, engine memory\n");
+    printf("  --jobs LIST          Benchmark trace sizes, e.g. 1000,10000000 (default %s)\n", BENCH_DEFAULT_JOBS);
+    printf("  --seed S             Synthetic workload seed (default 1)\n");
+    printf("  --what-if EDITED     Re-simulate EDITED, a changed copy of the input file, from the last\n");
+    printf("                       snapshot before the first change, and check it against a full re-run\n");
+    printf("                       (snapshots need a moment with no job resident, so a trace that keeps\n");
+    printf("                       the CPU busy throughout is re-run from the start)\n");
+    printf("  --snapshot-interval N  Simulated time between --what-if snapshots (default %d)\n",
+           SNAPSHOT_DEFAULT_INTERVAL);
+    printf("  --golden-write GOLDEN  Run each algorithm (twice) on the input file or on generated --jobs\n");
+    printf("                       traces and append their schedule fingerprints and budgets to GOLDEN\n");
+    printf("  --golden-check GOLDEN  Re-run every case in GOLDEN; fail on a changed schedule or a budget overrun\n");
+    printf("  -t, --trace LEVEL    Scheduler progress output: none, summary, dispatch (default)\n");
+    printf("  -h, --help           Show this help\n");
+}
+
+// Map a menu number to the algorithm it runs (ALGORITHM_ALL for "Run All");
+// returns 0 for entries that don't run an algorithm
+int menu_algorithm(int choice)
+{
+    switch (choice)
+    {
+    case 1:
+    case 2:
+    case 3:
+        return choice;
+    case MENU_RUN_ALL:
+        return ALGORITHM_ALL;
+    case MENU_SRTF:
+        return ALG_SRTF;
+    case MENU_PRIORITY:
+        return ALG_PRIORITY;
+    case MENU_MLFQ:
+        return ALG_MLFQ;
+    default:
+        return 0;
+    }
+}
+
+// Map an algorithm name or menu number to its id; returns 0 if unknown
+int parse_algorithm(const char *name)
+{
+    if (strcmp(name, "rr") == 0)
+        return ALG_ROUND_ROBIN;
+    if (strcmp(name, "aging") == 0)
+        return ALG_AGING;
+    if (strcmp(name, "sjf") == 0)
+        return ALG_SJF;
+    if (strcmp(name, "srtf") == 0)
+        return ALG_SRTF;
+    if (strcmp(name, "priority") == 0)
+        return ALG_PRIORITY;
+    if (strcmp(name, "mlfq") == 0)
+        return ALG_MLFQ;
+    if (strcmp(name, "all") == 0)
+        return ALGORITHM_ALL;
+    if (name[0] >= '1' && name[0] <= '9' && name[1] == '\0')
+        return menu_algorithm(name[0] - '0');
+    return 0;
+}
+
+// Parse "1-8,16,32" into a newly allocated array
+// Returns the number of values, or -1 if the list is malformed
+int parse_int_list(const char *text, int **values)
+{
+    int count = 0, capacity = 16;
+    int *list = (int *)malloc((size_t)capacity * sizeof(int));
+    const char *cursor = text;
+
+    while (list != NULL && *cursor != '\0')
+    {
+        char *end;
+        long low = strtol(cursor, &end, 10);
+        long high = low;
+        if (end == cursor || low <= 0)
+            break;
+        if (*end == '-')
+        {
+            cursor = end + 1;
+            high = strtol(cursor, &end, 10);
+            if (end == cursor || high < low)
+                break;
+        }
+
+        for (long value = low; value <= high; value++)
+        {
+            if (count == capacity)
+            {
+                int *grown = (int *)realloc(list, (size_t)capacity * 2 * sizeof(int));
+                if (grown == NULL)
+                {
+                    free(list);
+                    return -1;
+                }
+                list = grown;
+                capacity *= 2;
+            }
+            list[count++] = (int)value;
+        }
+
+        cursor = end;
+        if (*cursor == ',')
+            cursor++;
+        else if (*cursor != '\0')
+            break;
+    }
+
+    if (list == NULL || *cursor != '\0' || count == 0)
+    {
+        free(list);
+        return -1;
+    }
+    *values = list;
+    return count;
+}
+
+// Fill in options from argv
+// Returns 0 on success, 1 if help was printed, -1 on invalid arguments
+int parse_arguments(int argc, char *argv[], Options *options)
+{
+    options->input_file = NULL;
+    options->algorithm = 0;
+    options->quantum = 0;
+    options->format = FORMAT_TEXT;
+    options->convert_to = NULL;
+    options->stream = 0;
+    options->gantt_file = NULL;
+    options->gantt_svg = NULL;
+    options->stats = 0;
+    options->sweep = 0;
+    options->quanta = NULL;
+    options->threads = 0;
+    options->work_dir = NULL;
+    options->sweep_worker = NULL;
+    options->batch = 0;
+    options->claim_timeout = -1;
+    default_aging_weights(&options->weights);
+    options->search = -1;
+    options->cores = 1;
+    options->queues = QUEUE_GLOBAL;
+    default_mlfq_config(&options->mlfq);
+    options->switch_cost = 0;
+    options->aging_selection = AGING_SELECT_HEAP;
+    options->generate = 0;
+    options->bench = 0;
+    options->jobs = NULL;
+    options->seed = 1;
+    options->what_if = NULL;
+    options->snapshot_interval = SNAPSHOT_DEFAULT_INTERVAL;
+    options->golden_write = NULL;
+    options->golden_check = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        int has_value = i + 1 < argc;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else if (strcmp(arg, "-a") == 0 || strcmp(arg, "--algorithm") == 0)
+        {
+            if (!has_value || (options->algorithm = parse_algorithm(argv[++i])) == 0)
+            {
+                fprintf(stderr, "Error: --algorithm expects rr, aging, sjf, srtf, priority, mlfq, all or a menu number\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-q") == 0 || strcmp(arg, "--quantum") == 0)
+        {
+            if (!has_value || (options->quantum = atoi(argv[++i])) <= 0)
+            {
+                fprintf(stderr, "Error: --quantum expects a positive integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-f") == 0 || strcmp(arg, "--format") == 0)
+        {
+            const char *format = has_value ? argv[++i] : "";
+            if (strcmp(format, "text") == 0)
+                options->format = FORMAT_TEXT;
+            else if (strcmp(format, "summary") == 0)
+                options->format = FORMAT_SUMMARY;
+            else if (strcmp(format, "csv") == 0)
+                options->format = FORMAT_CSV;
+            else if (strcmp(format, "json") == 0)
+                options->format = FORMAT_JSON;
+            else
+            {
+                fprintf(stderr, "Error: --format expects text, summary, csv or json\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--stream") == 0)
+        {
+            options->stream = 1;
+        }
+        else if (strcmp(arg, "-g") == 0 || strcmp(arg, "--gantt-file") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --gantt-file expects an output filename\n");
+                return -1;
+            }
+            options->gantt_file = argv[++i];
+        }
+        else if (strcmp(arg, "--gantt-svg") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --gantt-svg expects an output filename\n");
+                return -1;
+            }
+            options->gantt_svg = argv[++i];
+        }
+        else if (strcmp(arg, "--stats") == 0)
+        {
+            options->stats = 1;
+        }
+        else if (strcmp(arg, "--sweep") == 0)
+        {
+            options->sweep = 1;
+        }
+        else if (strcmp(arg, "--quanta") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --quanta expects a list such as 1-8,16\n");
+                return -1;
+            }
+            options->quanta = argv[++i];
+        }
+        else if (strcmp(arg, "--threads") == 0)
+        {
+            if (!has_value || (options->threads = atoi(argv[++i])) <= 0)
+            {
+                fprintf(stderr, "Error: --threads expects a positive integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--work-dir") == 0 || strcmp(arg, "--sweep-worker") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: %s expects a directory\n", arg);
+                return -1;
+            }
+            if (strcmp(arg, "--work-dir") == 0)
+                options->work_dir = argv[++i];
+            else
+                options->sweep_worker = argv[++i];
+        }
+        else if (strcmp(arg, "--batch") == 0)
+        {
+            if (!has_value || (options->batch = atoi(argv[++i])) <= 0)
+            {
+                fprintf(stderr, "Error: --batch expects a positive integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--claim-timeout") == 0)
+        {
+            if (!has_value || (options->claim_timeout = atoi(argv[++i])) < 0)
+            {
+                fprintf(stderr, "Error: --claim-timeout expects a non-negative number of seconds\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-w") == 0 || strcmp(arg, "--weights") == 0)
+        {
+            AgingWeights *w = &options->weights;
+            char extra;
+            if (!has_value ||
+                sscanf(argv[++i], "%lf,%lf,%lf%c", &w->aging, &w->burst, &w->priority, &extra) != 3 ||
+                w->aging < 0.0 || w->burst < 0.0 || w->priority < 0.0)
+            {
+                fprintf(stderr, "Error: --weights expects three non-negative numbers, e.g. 2.0,0.5,3.0\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--search-weights") == 0)
+        {
+            const char *objective = has_value ? argv[++i] : "";
+            if (strcmp(objective, "waiting") == 0)
+                options->search = SEARCH_MIN_WAITING;
+            else if (strcmp(objective, "turnaround") == 0)
+                options->search = SEARCH_MIN_TURNAROUND;
+            else
+            {
+                fprintf(stderr, "Error: --search-weights expects waiting or turnaround\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--aging-select") == 0)
+        {
+            const char *mode = has_value ? argv[++i] : "";
+            if (strcmp(mode, "heap") == 0)
+                options->aging_selection = AGING_SELECT_HEAP;
+            else if (strcmp(mode, "scan") == 0)
+                options->aging_selection = AGING_SELECT_SCAN;
+            else
+            {
+                fprintf(stderr, "Error: --aging-select expects heap or scan\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--mlfq-quanta") == 0)
+        {
+            int *quanta = NULL;
+            int levels = has_value ? parse_int_list(argv[++i], &quanta) : -1;
+            if (levels < 1 || levels > MLFQ_MAX_LEVELS)
+            {
+                fprintf(stderr, "Error: --mlfq-quanta expects 1 to %d positive quanta, e.g. 2,4,8\n", MLFQ_MAX_LEVELS);
+                free(quanta);
+                return -1;
+            }
+            options->mlfq.levels = levels;
+            memcpy(options->mlfq.quanta, quanta, (size_t)levels * sizeof(int));
+            free(quanta);
+        }
+        else if (strcmp(arg, "--boost") == 0)
+        {
+            if (!has_value || (options->mlfq.boost_interval = atoi(argv[++i])) < 0)
+            {
+                fprintf(stderr, "Error: --boost expects a non-negative integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-n") == 0 || strcmp(arg, "--cores") == 0)
+        {
+            if (!has_value || (options->cores = atoi(argv[++i])) <= 0 || options->cores > MAX_CORES)
+            {
+                fprintf(stderr, "Error: --cores expects an integer from 1 to %d\n", MAX_CORES);
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--queues") == 0)
+        {
+            const char *mode = has_value ? argv[++i] : "";
+            if (strcmp(mode, "global") == 0)
+                options->queues = QUEUE_GLOBAL;
+            else if (strcmp(mode, "per-core") == 0)
+                options->queues = QUEUE_PER_CORE;
+            else
+            {
+                fprintf(stderr, "Error: --queues expects global or per-core\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--switch-cost") == 0)
+        {
+            if (!has_value || (options->switch_cost = atoi(argv[++i])) < 0)
+            {
+                fprintf(stderr, "Error: --switch-cost expects a non-negative integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "-c") == 0 || strcmp(arg, "--convert") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --convert expects an output filename\n");
+                return -1;
+            }
+            options->convert_to = argv[++i];
+        }
+        else if (strcmp(arg, "--generate") == 0)
+        {
+            if (!has_value || (options->generate = atoi(argv[++i])) <= 0)
+            {
+                fprintf(stderr, "Error: --generate expects a positive number of processes\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--bench") == 0)
+        {
+            options->bench = 1;
+        }
+        else if (strcmp(arg, "--jobs") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --jobs expects a list such as 1000,10000\n");
+                return -1;
+            }
+            options->jobs = argv[++i];
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            char *end = NULL;
+            if (has_value)
+                options->seed = (uint64_t)strtoull(argv[++i], &end, 10);
+            if (end == NULL || end == argv[i] || *end != '\0' || argv[i][0] == '-')
+            {
+                fprintf(stderr, "Error: --seed expects a non-negative integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--what-if") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: --what-if expects the edited process file\n");
+                return -1;
+            }
+            options->what_if = argv[++i];
+        }
+        else if (strcmp(arg, "--snapshot-interval") == 0)
+        {
+            if (!has_value || (options->snapshot_interval = strtoll(argv[++i], NULL, 10)) <= 0)
+            {
+                fprintf(stderr, "Error: --snapshot-interval expects a positive integer\n");
+                return -1;
+            }
+        }
+        else if (strcmp(arg, "--golden-write") == 0 || strcmp(arg, "--golden-check") == 0)
+        {
+            if (!has_value)
+            {
+                fprintf(stderr, "Error: %s expects a golden file\n", arg);
+                return -1;
+            }
+            if (strcmp(arg, "--golden-write") == 0)
+                options->golden_write = argv[++i];
+            else
+                options->golden_check = argv[++i];
+        }
+        else if (strcmp(arg, "-t") == 0 || strcmp(arg, "--trace") == 0)
+        {
+            const char *level = has_value ? argv[++i] : "";
+            if (strcmp(level, "none") == 0)
+                trace_level = TRACE_NONE;
+            else if (strcmp(level, "summary") == 0)
+                trace_level = TRACE_SUMMARY;
+            else if (strcmp(level, "dispatch") == 0)
+                trace_level = TRACE_DISPATCH;
+            else
+            {
+                fprintf(stderr, "Error: --trace expects none, summary or dispatch\n");
+                return -1;
+            }
+        }
+        else if (arg[0] == '-' && arg[1] != '\0')
+        {
+            fprintf(stderr, "Error: Unknown option '%s'\n", arg);
+            return -1;
+        }
+        else if (options->input_file == NULL)
+        {
+            options->input_file = arg;
+        }
+        else
+        {
+            fprintf(stderr, "Error: Only one input file may be given\n");
+            return -1;
+        }
+    }
+
+    if (options->convert_to != NULL && options->input_file == NULL)
+    {
+        fprintf(stderr, "Error: --convert needs an input file\n");
+        return -1;
+    }
+
+    if (options->generate > 0 && options->input_file == NULL)
+    {
+        fprintf(stderr, "Error: --generate needs an output filename\n");
+        return -1;
+    }
+
+    // engine_stats is one global, so only single-threaded batch runs may use it
+    if (options->stats &&
+        (options->algorithm == 0 || options->search >= 0 || options->sweep || options->bench ||
+         options->what_if != NULL || options->stream))
+    {
+        fprintf(stderr, "Error: --stats needs a plain --algorithm run (no sweep, search, bench, what-if or stream)\n");
+        return -1;
+    }
+    if (options->stats && !ENGINE_STATS)
+    {
+        fprintf(stderr, "Error: --stats is not available: this build has ENGINE_STATS=0\n");
+        return -1;
+    }
+
+    // A worker takes the trace and every setting from the plan
+    if (options->sweep_worker != NULL)
+    {
+        if (options->input_file != NULL || options->algorithm != 0 || options->sweep || options->format != FORMAT_TEXT)
+        {
+            fprintf(stderr, "Error: --sweep-worker reads the trace and configurations from the plan; give only --threads\n");
+            return -1;
+        }
+        trace_level = TRACE_NONE;
+        return 0;
+    }
+    // A check takes every case from the golden file
+    if (options->golden_check != NULL)
+    {
+        if (options->input_file != NULL || options->algorithm != 0 || options->golden_write != NULL ||
+            options->format != FORMAT_TEXT || options->sweep || options->bench || options->stream)
+        {
+            fprintf(stderr, "Error: --golden-check reads every case from the golden file; give nothing else\n");
+            return -1;
+        }
+        trace_level = TRACE_NONE;
+        return 0;
+    }
+    if (options->golden_write != NULL)
+    {
+        if ((options->input_file == NULL) == (options->jobs == NULL))
+        {
+            fprintf(stderr, "Error: --golden-write needs an input file or --jobs (not both)\n");
+            return -1;
+        }
+        if (options->format != FORMAT_TEXT || options->sweep || options->bench || options->stream ||
+            options->what_if != NULL || options->search >= 0 || options->cores > 1)
+        {
+            fprintf(stderr, "Error: --golden-write records plain single-CPU runs; drop the other modes\n");
+            return -1;
+        }
+        if (options->algorithm == 0)
+            options->algorithm = ALGORITHM_ALL;
+        if (options->quantum == 0)
+            options->quantum = BENCH_DEFAULT_QUANTUM;
+        trace_level = TRACE_NONE;
+        return 0;
+    }
+
+    if ((options->work_dir != NULL || options->batch > 0 || options->claim_timeout >= 0) && !options->sweep)
+    {
+        fprintf(stderr, "Error: --work-dir, --batch and --claim-timeout need --sweep\n");
+        return -1;
+    }
+    if ((options->batch > 0 || options->claim_timeout >= 0) && options->work_dir == NULL)
+    {
+        fprintf(stderr, "Error: --batch and --claim-timeout need --work-dir\n");
+        return -1;
+    }
+
+    if (options->cores > 1 && (options->search >= 0 || options->sweep || options->bench || options->what_if != NULL))
+    {
+        fprintf(stderr, "Error: sweeps, weight searches, benchmarks and --what-if simulate one CPU; drop --cores\n");
+        return -1;
+    }
+
+    // Like --bench, only the comparison table is printed
+    if (options->what_if != NULL)
+    {
+        if (options->input_file == NULL || options->algorithm == 0)
+        {
+            fprintf(stderr, "Error: --what-if needs --algorithm and the original input file\n");
+            return -1;
+        }
+        if (options->format != FORMAT_TEXT)
+        {
+            fprintf(stderr, "Error: --what-if prints a text table; drop --format\n");
+            return -1;
+        }
+        if (options->quantum == 0 && (options->algorithm == ALG_ROUND_ROBIN || options->algorithm == ALGORITHM_ALL))
+        {
+            fprintf(stderr, "Error: Round Robin needs --quantum\n");
+            return -1;
+        }
+        trace_level = TRACE_NONE;
+        return 0;
+    }
+
+    // Timed runs print nothing but the table, so the clock measures the engines
+    if (options->bench)
+    {
+        if (options->format != FORMAT_TEXT)
+        {
+            fprintf(stderr, "Error: --bench prints a text table; drop --format\n");
+            return -1;
+        }
+        if (options->algorithm == 0)
+            options->algorithm = ALGORITHM_ALL;
+        if (options->quantum == 0)
+            options->quantum = BENCH_DEFAULT_QUANTUM;
+        trace_level = TRACE_NONE;
+        return 0;
+    }
+
+    if (options->cores > 1 && options->gantt_file != NULL)
+    {
+        fprintf(stderr, "Error: --gantt-file writes a single-CPU timeline; drop --cores\n");
+        return -1;
+    }
+
+    // Records go to stdout, so nothing else may be printed there
+    if (options->format >= FORMAT_CSV)
+    {
+        if (options->algorithm == 0 && !options->sweep)
+        {
+            fprintf(stderr, "Error: --format csv/json needs --algorithm or --sweep\n");
+            return -1;
+        }
+        trace_level = TRACE_NONE;
+    }
+
+    if (options->search >= 0)
+    {
+        if (options->input_file == NULL)
+        {
+            fprintf(stderr, "Error: --search-weights needs an input file\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (options->sweep)
+    {
+        if (options->input_file == NULL)
+        {
+            fprintf(stderr, "Error: --sweep needs an input file\n");
+            return -1;
+        }
+        if (options->algorithm == 0)
+            options->algorithm = ALGORITHM_ALL;
+        if (options->quanta == NULL && options->quantum == 0 &&
+            (options->algorithm == ALG_ROUND_ROBIN || options->algorithm == ALGORITHM_ALL))
+        {
+            fprintf(stderr, "Error: Round Robin sweeps need --quanta or --quantum\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (options->stream && options->algorithm == 0)
+    {
+        fprintf(stderr, "Error: --stream needs --algorithm\n");
+        return -1;
+    }
+
+    if (options->gantt_file != NULL && (options->algorithm == 0 || options->algorithm == ALGORITHM_ALL))
+    {
+        fprintf(stderr, "Error: --gantt-file needs a single --algorithm\n");
+        return -1;
+    }
+
+    // The SVG is drawn from the same in-memory chart as the text one
+    if (options->gantt_svg != NULL)
+    {
+        if (options->algorithm == 0 || options->algorithm == ALGORITHM_ALL)
+        {
+            fprintf(stderr, "Error: --gantt-svg needs a single --algorithm\n");
+            return -1;
+        }
+        if (options->format != FORMAT_TEXT || options->stream || options->gantt_file != NULL)
+        {
+            fprintf(stderr, "Error: --gantt-svg draws the text-format chart; drop --format, --stream and --gantt-file\n");
+            return -1;
+        }
+    }
+
+    // Batch runs must never block on stdin
+    if (options->algorithm != 0)
+    {
+        if (options->input_file == NULL)
+        {
+            fprintf(stderr, "Error: --algorithm needs an input file\n");
+            return -1;
+        }
+        if (options->quantum == 0 && (options->algorithm == 1 || options->algorithm == ALGORITHM_ALL))
+        {
+            fprintf(stderr, "Error: Round Robin needs --quantum in batch mode\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Function to display the main menu
+void display_menu()
+{
+    printf("\n");
+    printf("========================================\n");
+    printf("     CPU SCHEDULING ALGORITHMS\n");
+    printf("========================================\n");
+    printf("[1] Round Robin\n");
+    printf("    (e.g., SRTF / Preemptive Priority / Round Robin)\n");
+    printf("\n");
+    printf("[2] Modified FCFS with Aging\n");
+    printf("    (e.g., FCFS / SJF / Non-preemptive Priority)\n");
+    printf("\n");
+    printf("[3] Shortest Job First (SJF)\n");
+    printf("    (e.g., FCFS / SJF / Non-preemptive Priority)\n");
+    printf("\n");
+    printf("[4] Run All Algorithms\n");
+    printf("[5] Display Loaded Processes\n");
+    printf("[6] Reload Processes from File\n");
+    printf("\n");
+    printf("[7] Shortest Remaining Time First (SRTF)\n");
+    printf("    (e.g., SRTF / Preemptive Priority / Round Robin)\n");
+    printf("\n");
+    printf("[8] Preemptive Priority\n");
+    printf("    (e.g., SRTF / Preemptive Priority / Round Robin)\n");
+    printf("\n");
+    printf("[9] Multilevel Feedback Queue (MLFQ)\n");
+    printf("    (Round Robin levels with demotion and priority boost)\n");
+    printf("\n");
+    printf("[0] Exit\n");
+    printf("========================================\n");
+    printf("Enter your choice: ");
+}
+
+// Function to display loaded processes
+void display_loaded_processes(Process processes[], int n)
+{
+    if (n <= 0)
+    {
+        printf("\nNo processes loaded.\n");
+        return;
+    }
+
+    printf("\n===== LOADED PROCESSES =====\n");
+    printf("+-----+----------+-------+----------+\n");
+    printf("| PID |  Arrival | Burst | Priority |\n");
+    printf("+-----+----------+-------+----------+\n");
+
+    for (int i = 0; i < n; i++)
+    {
+        printf("| %3d | %8lld | %5lld | %8d |\n",
+               processes[i].pid,
+               processes[i].arrival_time,
+               processes[i].burst_time,
+               processes[i].priority);
+    }
+
+    printf("+-----+----------+-------+----------+\n");
+    printf("Total: %d processes\n", n);
+}
+
+// Ask for the Round Robin time quantum (interactive mode only)
+int prompt_time_quantum()
+{
+    int quantum = 0;
+    printf("Enter time quantum: ");
+    scanf("%d", &quantum);
+    if (quantum <= 0)
+    {
+        printf("Invalid quantum, defaulting to 1.\n");
+        quantum = 1;
+    }
+    return quantum;
+}
+
+// Load a file into the process table and sort it by arrival time
+// Returns the number of processes loaded (<= 0 if nothing usable was loaded)
+// (verbose 0 = only errors, for machine-readable output)
+int load_processes(const char *filename, ProcessTable *processes, int verbose)
+{
+    double since = STAT_CLOCK();
+    int process_count = read_processes_from_file(filename, processes);
+    STAT_PHASE(PHASE_LOAD, since);
+
+    if (process_count > 0 && verbose)
+    {
+        printf("\nSuccessfully loaded %d processes from '%s'\n", process_count, filename);
+    }
+    if (process_count > 0)
+    {
+        since = STAT_CLOCK();
+        sort_by_arrival(processes->items, process_count); // Sort by arrival time initially
+        STAT_PHASE(PHASE_SORT, since);
+    }
+    else if (process_count == 0)
+    {
+        printf("\nWarning: File '%s' contains no valid process data.\n", filename);
+    }
+    // If process_count < 0, error message already printed by read function
+
+    return process_count;
+}
+
+// Summary-line suffix for the latency tail (SLAs are set on these, not the means)
+void print_latency_summary(const ScheduleMetrics *metrics)
+{
+    printf(" avg_response=%.2f p95_turnaround=%lld p99_turnaround=%lld max_turnaround=%lld avg_slowdown=%.2f",
+           metrics->response.mean, metrics->turnaround.p95, metrics->turnaround.p99, metrics->turnaround.max,
+           metrics->avg_slowdown);
+}
+
+// Summary-line suffix for the context switches in a run (nothing when switches are free)
+void print_switch_summary(const GanttSink *gantt, SimTime capacity)
+{
+    if (gantt->switch_cost > 0)
+        printf(" switches=%d switch_overhead=%.2f%%", gantt->switches,
+               capacity > 0 ? 100.0 * gantt->switch_time / capacity : 0.0);
+}
+
+// Zero engine_stats for the next run, keeping the load and sort times it shares
+static void begin_engine_stats(void)
+{
+    if (engine_stats == NULL)
+        return;
+    double load = engine_stats->seconds[PHASE_LOAD];
+    double sort = engine_stats->seconds[PHASE_SORT];
+    memset(engine_stats, 0, sizeof(*engine_stats));
+    engine_stats->seconds[PHASE_LOAD] = load;
+    engine_stats->seconds[PHASE_SORT] = sort;
+}
+
+// Charge the report started at `since` to PHASE_RENDER, less the metrics
+// computed meanwhile (already in PHASE_METRICS), and show the stats next to
+// the results: a stats record when they go to results, a table otherwise
+static void report_engine_stats(double since, double metrics_before, ResultsWriter *results)
+{
+    if (engine_stats == NULL)
+        return;
+    double metrics = engine_stats->seconds[PHASE_METRICS] - metrics_before;
+    engine_stats->seconds[PHASE_RENDER] += benchmark_clock() - since - metrics;
+    if (results != NULL)
+        results_write_stats(results, engine_stats);
+    else
+        display_engine_stats(engine_stats);
+}
+
+// Simulate config->cores CPUs on an already reset working copy, charging
+// switch_cost per context switch, and report per-CPU charts (text format, also
+// drawn to svg_file unless it is NULL) and utilization, or records to results
+void run_multicore(Process working[], int n, const MulticoreConfig *config, int switch_cost, int format,
+                   const char *svg_file, ResultsWriter *results)
+{
+    GanttSink gantt;
+    GanttSink *lanes = (GanttSink *)malloc((size_t)config->cores * sizeof(GanttSink));
+    GanttBuffer *charts = (GanttBuffer *)malloc((size_t)config->cores * sizeof(GanttBuffer));
+    if (lanes == NULL || charts == NULL)
+    {
+        printf("\nError: Could not allocate Gantt lanes for %d CPUs.\n", config->cores);
+        free(lanes);
+        free(charts);
+        return;
+    }
+    for (int c = 0; c < config->cores; c++)
+    {
+        gantt_sink_init_buffer(&lanes[c], &charts[c]);
+        if (format == FORMAT_SUMMARY)
+            gantt_sink_init_summary(&lanes[c]);
+    }
+    gantt_sink_init_lanes(&gantt, lanes);
+    if (results != NULL)
+    {
+        // Blocks carry their core, so one record stream covers every CPU
+        gantt_sink_init_results(&gantt, results);
+        results_begin_run(results, algorithm_names[config->algorithm],
+                          config->algorithm == ALG_ROUND_ROBIN ? config->quantum : 0, config->cores, switch_cost);
+    }
+    gantt.switch_cost = switch_cost;
+
+    double since = STAT_CLOCK();
+    multicore_algorithm(working, n, config, &gantt);
+    STAT_PHASE(PHASE_SCHEDULE, since);
+
+    since = STAT_CLOCK();
+    double metrics_before = engine_stats != NULL ? engine_stats->seconds[PHASE_METRICS] : 0.0;
+    const char *queues = config->queues == QUEUE_PER_CORE ? "per-core queues" : "global queue";
+    ScheduleMetrics metrics;
+    if (results != NULL && compute_schedule_metrics(working, n, &metrics) == 0)
+    {
+        results_write_processes(results, working, n);
+        results_write_summary(results, &gantt, config->cores, &metrics);
+    }
+    else if (gantt.blocks > 0 && format == FORMAT_SUMMARY && compute_schedule_metrics(working, n, &metrics) == 0)
+    {
+        SimTime capacity = (gantt.last_end - gantt.first_start) * config->cores;
+        printf("%s", algorithm_names[config->algorithm]);
+        if (config->algorithm == ALG_ROUND_ROBIN)
+            printf(" (quantum %d)", config->quantum);
+        printf(" on %d CPUs, %s: processes=%d avg_waiting=%.2f avg_turnaround=%.2f cpu_utilization=%.2f%%",
+               config->cores, queues, n, metrics.waiting.mean, metrics.turnaround.mean,
+               capacity > 0 ? 100.0 * gantt.busy_time / capacity : 0.0);
+        print_latency_summary(&metrics);
+        print_switch_summary(&gantt, capacity);
+        printf("\n");
+    }
+    else if (gantt.blocks > 0 && format != FORMAT_SUMMARY && results == NULL)
+    {
+        for (int c = 0; c < config->cores; c++)
+        {
+            printf("\n----- CPU %d -----", c);
+            display_gantt_chart(charts[c].blocks, charts[c].size);
+        }
+        if (svg_file != NULL && write_gantt_svg(svg_file, charts, config->cores) == 0)
+            printf("\nGantt chart drawn to '%s'\n", svg_file);
+        if (TRACE_ENABLED(TRACE_SUMMARY))
+            display_core_utilization(lanes, config->cores, switch_cost);
+        display_results(working, n);
+    }
+    report_engine_stats(since, metrics_before, results);
+
+    for (int c = 0; c < config->cores; c++)
+        gantt_buffer_free(&charts[c]);
+    free(lanes);
+    free(charts);
+}
+
+// Run a specific algorithm with the parameters in options
+// (options->quantum 0 means ask for the Round Robin quantum interactively;
+// options->cores > 1 simulates that many CPUs).
+// gantt_file, if set, receives the Gantt blocks as they are produced instead of
+// keeping them in memory for the chart (single CPU only).
+// results, if set, receives run, gantt, process and summary records instead of
+// any text output (format is then ignored).
+void run_algorithm(Process original[], int n, int algorithm_choice, const Options *options, int format,
+                   FILE *gantt_file, ResultsWriter *results)
+{
+    int quantum = options->quantum;
+    int cores = options->cores;
+
+    if (n <= 0)
+    {
+        printf("\nError: No processes loaded. Please load processes from file first.\n");
+        return;
+    }
+
+    // Create a working copy to preserve original data
+    Process *working = (Process *)malloc((size_t)n * sizeof(Process));
+    if (working == NULL)
+    {
+        printf("\nError: Could not allocate working storage for %d processes.\n", n);
+        return;
+    }
+
+    copy_processes(original, working, n);
+    reset_processes(working, n);
+    begin_engine_stats();
+
+    if (cores > 1 && algorithm_choice > ALG_SJF && algorithm_choice <= ALG_COUNT)
+        fprintf(results != NULL ? stderr : stdout, "\nNote: %s is simulated on one CPU; --cores is ignored.\n",
+                algorithm_names[algorithm_choice]);
+    else if (cores > 1 && algorithm_choice >= ALG_ROUND_ROBIN && algorithm_choice <= ALG_SJF)
+    {
+        MulticoreConfig config;
+        if (algorithm_choice == ALG_ROUND_ROBIN && quantum <= 0)
+            quantum = prompt_time_quantum();
+        config.algorithm = algorithm_choice;
+        config.quantum = quantum;
+        config.weights = options->weights;
+        config.cores = cores;
+        config.queues = options->queues;
+        TRACE(TRACE_SUMMARY, "\n===== %s =====\n", algorithm_names[algorithm_choice]);
+        run_multicore(working, n, &config, options->switch_cost, format, options->gantt_svg, results);
+        free(working);
+        return;
+    }
+
+    // Gantt chart storage: only the text chart needs every block in memory
+    GanttSink gantt;
+    GanttBuffer chart;
+    gantt_sink_init_buffer(&gantt, &chart);
+    if (gantt_file != NULL)
+        gantt_sink_init_file(&gantt, gantt_file);
+    else if (results != NULL)
+        gantt_sink_init_results(&gantt, results);
+    else if (format == FORMAT_SUMMARY)
+        gantt_sink_init_summary(&gantt);
+    if (results != NULL && algorithm_choice >= ALG_ROUND_ROBIN && algorithm_choice <= ALG_COUNT)
+        results_begin_run(results, algorithm_names[algorithm_choice],
+                          algorithm_choice == ALG_ROUND_ROBIN ? quantum : 0, 1, options->switch_cost);
+    gantt.switch_cost = options->switch_cost;
+
+    // Run the selected algorithm
+    double since = STAT_CLOCK();
+    switch (algorithm_choice)
+    {
+    case 1:
+        TRACE(TRACE_SUMMARY, "\n===== PREEMPTIVE ALGORITHM =====\n");
+        if (quantum <= 0)
+            quantum = prompt_time_quantum();
+        preemptive_algorithm(working, n, quantum, &gantt);
+        break;
+    case 2:
+        TRACE(TRACE_SUMMARY, "\n===== MODIFIED FCFS WITH AGING =====\n");
+        modified_FCFS_with_aging(working, n, &options->weights, options->aging_selection, &gantt);
+        break;
+    case 3:
+        TRACE(TRACE_SUMMARY, "\n===== NON-PREEMPTIVE ALGORITHM 2 =====\n");
+        non_preemptive_algorithm_2(working, n, &gantt);
+        break;
+    case ALG_SRTF:
+        srtf_algorithm(working, n, &gantt);
+        break;
+    case ALG_PRIORITY:
+        preemptive_priority_algorithm(working, n, &gantt);
+        break;
+    case ALG_MLFQ:
+        mlfq_algorithm(working, n, &options->mlfq, &gantt);
+        break;
+    default:
+        printf("\nInvalid algorithm choice.\n");
+        free(working);
+        return;
+    }
+    STAT_PHASE(PHASE_SCHEDULE, since);
+
+    // Display results if algorithm was implemented
+    since = STAT_CLOCK();
+    double metrics_before = engine_stats != NULL ? engine_stats->seconds[PHASE_METRICS] : 0.0;
+    ScheduleMetrics metrics;
+    if (results != NULL && compute_schedule_metrics(working, n, &metrics) == 0)
+    {
+        results_write_processes(results, working, n);
+        results_write_summary(results, &gantt, 1, &metrics);
+    }
+    else if (gantt.blocks > 0 && format == FORMAT_SUMMARY && compute_schedule_metrics(working, n, &metrics) == 0)
+    {
+        if (algorithm_choice == 1)
+            printf("%s (quantum %d): processes=%d avg_waiting=%.2f avg_turnaround=%.2f",
+                   algorithm_names[algorithm_choice], quantum, n, metrics.waiting.mean, metrics.turnaround.mean);
+        else
+            printf("%s: processes=%d avg_waiting=%.2f avg_turnaround=%.2f",
+                   algorithm_names[algorithm_choice], n, metrics.waiting.mean, metrics.turnaround.mean);
+        print_latency_summary(&metrics);
+        print_switch_summary(&gantt, gantt.last_end - gantt.first_start);
+        printf("\n");
+    }
+    else if (gantt.blocks > 0 && format != FORMAT_SUMMARY && results == NULL)
+    {
+        if (chart.size > 0)
+            display_gantt_chart(chart.blocks, chart.size);
+        else
+            printf("\nGantt chart: %d blocks written to file\n", gantt.blocks);
+        if (options->gantt_svg != NULL && write_gantt_svg(options->gantt_svg, &chart, 1) == 0)
+            printf("\nGantt chart drawn to '%s'\n", options->gantt_svg);
+        display_results(working, n);
+    }
+    report_engine_stats(since, metrics_before, results);
+
+    gantt_buffer_free(&chart);
+    free(working);
+}
+
+// Non-interactive run driven entirely by the command line
+int run_batch(const Options *options)
+{
+    ProcessTable processes;
+    init_process_table(&processes);
+
+    int process_count = load_processes(options->input_file, &processes, options->format < FORMAT_CSV);
+    if (process_count <= 0)
+    {
+        free_process_table(&processes);
+        return 1;
+    }
+
+    FILE *gantt_file = NULL;
+    if (options->gantt_file != NULL && (gantt_file = fopen(options->gantt_file, "w")) == NULL)
+    {
+        fprintf(stderr, "Error: Could not create file '%s'\n", options->gantt_file);
+        free_process_table(&processes);
+        return 1;
+    }
+
+    ResultsWriter writer;
+    ResultsWriter *results = NULL;
+    if (options->format >= FORMAT_CSV)
+    {
+        if (results_writer_open(&writer, stdout, options->format == FORMAT_JSON ? RESULTS_JSON : RESULTS_CSV) != 0)
+        {
+            if (gantt_file != NULL)
+                fclose(gantt_file);
+            free_process_table(&processes);
+            return 1;
+        }
+        results = &writer;
+    }
+
+    int first = options->algorithm == ALGORITHM_ALL ? 1 : options->algorithm;
+    int last = options->algorithm == ALGORITHM_ALL ? ALG_COUNT : options->algorithm;
+    for (int i = first; i <= last; i++)
+        run_algorithm(processes.items, process_count, i, options, options->format, gantt_file, results);
+
+    if (results != NULL)
+        results_writer_close(results);
+    if (gantt_file != NULL)
+        fclose(gantt_file);
+    free_process_table(&processes);
+    return 0;
+}
+
+// Running totals for streaming mode (nothing per process is kept)
+typedef struct
+{
+    MetricsAccumulator metrics; // Constant-size latency histograms
+    int verbose;            // Print every event (text format) or only the summary
+    ResultsWriter *results; // Write a process record per completion instead (csv/json)
+} StreamTotals;
+
+// GanttSink backend that prints each block as it is produced
+void stream_print_gantt(GanttSink *sink, const GanttBlock *block)
+{
+    (void)sink;
+    if (block->pid == -1)
+        printf("[Gantt] IDLE %lld -> %lld\n", block->start_time, block->end_time);
+    else if (block->pid == GANTT_SWITCH)
+        printf("[Gantt] CS %lld -> %lld\n", block->start_time, block->end_time);
+    else
+        printf("[Gantt] P%d %lld -> %lld\n", block->pid, block->start_time, block->end_time);
+}
+
+void stream_print_completion(void *context, const Process *process, int seq)
+{
+    StreamTotals *totals = (StreamTotals *)context;
+
+    (void)seq;
+    metrics_accumulator_add(&totals->metrics, process);
+
+    if (totals->results != NULL)
+        results_write_process(totals->results, process);
+    else if (totals->verbose)
+        printf("[Done] P%d arrival=%lld burst=%lld completion=%lld turnaround=%lld waiting=%lld\n",
+               process->pid, process->arrival_time, process->burst_time,
+               process->completion_time, process->turnaround_time, process->waiting_time);
+}
+
+// Schedule straight from the file: memory follows the ready set, not the trace length
+int run_stream(const Options *options)
+{
+    if (is_binary_trace_file(options->input_file))
+    {
+        fprintf(stderr, "Error: --stream reads CSV traces; '%s' is a binary trace\n", options->input_file);
+        return 1;
+    }
+
+    ResultsWriter writer;
+    ResultsWriter *results = NULL;
+    if (options->format >= FORMAT_CSV)
+    {
+        if (results_writer_open(&writer, stdout, options->format == FORMAT_JSON ? RESULTS_JSON : RESULTS_CSV) != 0)
+            return 1;
+        results = &writer;
+    }
+
+    int status = 0;
+    int first = options->algorithm == ALGORITHM_ALL ? 1 : options->algorithm;
+    int last = options->algorithm == ALGORITHM_ALL ? ALG_COUNT : options->algorithm;
+    for (int i = first; i <= last; i++)
+    {
+        ProcessReader reader;
+        if (process_reader_open(&reader, options->input_file) != 0)
+        {
+            status = 1;
+            break;
+        }
+
+        ProcessSource source;
+        process_source_init(&source, process_source_read_file, &reader);
+
+        StreamTotals totals;
+        memset(&totals, 0, sizeof(totals));
+        totals.verbose = options->format == FORMAT_TEXT;
+        totals.results = results;
+
+        GanttSink gantt;
+        gantt_sink_init_summary(&gantt);
+        if (results != NULL)
+        {
+            int multicore = options->cores > 1 && i <= ALG_SJF;
+            gantt_sink_init_results(&gantt, results);
+            results_begin_run(results, algorithm_names[i], i == ALG_ROUND_ROBIN ? options->quantum : 0,
+                              multicore ? options->cores : 1, options->switch_cost);
+        }
+        else if (totals.verbose)
+            gantt.write = stream_print_gantt;
+        gantt.switch_cost = options->switch_cost;
+
+        ScheduleListener listener;
+        listener.gantt = &gantt;
+        listener.on_complete = stream_print_completion;
+        listener.context = &totals;
+        listener.snapshots = NULL;
+
+        int peak_jobs = 0;
+        if (options->cores > 1 && i <= ALG_SJF)
+        {
+            MulticoreConfig config;
+            config.algorithm = i;
+            config.quantum = options->quantum;
+            config.weights = options->weights;
+            config.cores = options->cores;
+            config.queues = options->queues;
+            peak_jobs = multicore_engine(&source, &config, &listener);
+        }
+        else if (i == 1)
+            peak_jobs = round_robin_engine(&source, options->quantum, &listener);
+        else if (i == 2)
+            peak_jobs = aging_engine(&source, &options->weights, options->aging_selection, &listener);
+        else if (i == 3)
+            peak_jobs = sjf_engine(&source, &listener);
+        else if (i == ALG_SRTF)
+            peak_jobs = srtf_engine(&source, &listener);
+        else if (i == ALG_PRIORITY)
+            peak_jobs = priority_engine(&source, &listener);
+        else
+            peak_jobs = mlfq_engine(&source, &options->mlfq, &listener);
+
+        process_reader_close(&reader);
+
+        // Per-CPU idle tails are never reported, so measure capacity over the whole run
+        SimTime total_time = gantt.busy_time + gantt.idle_time + gantt.switch_time;
+        if (options->cores > 1 && i <= ALG_SJF)
+            total_time = gantt.blocks > 0 ? (gantt.last_end - gantt.first_start) * options->cores : 0;
+        ScheduleMetrics metrics;
+        metrics_accumulator_finish(&totals.metrics, &metrics);
+        if (results != NULL)
+        {
+            results_write_summary(results, &gantt, options->cores > 1 && i <= ALG_SJF ? options->cores : 1,
+                                  &metrics);
+            continue;
+        }
+        printf("%s (streamed): processes=%d avg_waiting=%.2f avg_turnaround=%.2f cpu_utilization=%.2f%% peak_jobs_in_memory=%d",
+               algorithm_names[i], metrics.processes, metrics.waiting.mean, metrics.turnaround.mean,
+               total_time > 0 ? 100.0 * gantt.busy_time / total_time : 0.0, peak_jobs);
+        print_latency_summary(&metrics);
+        print_switch_summary(&gantt, total_time);
+        printf("\n");
+    }
+
+    if (results != NULL)
+        results_writer_close(results);
+    return status;
+}
+
+void display_sweep_results(const SweepConfig configs[], const SweepResult results[], int count)
+{
+    // Switch columns only when switches cost something
+    int switches = 0;
+    for (int i = 0; i < count; i++)
+        switches = switches || configs[i].switch_cost > 0;
+    const char *rule = "+------+--------------------------------------+---------+-----------+--------------+------------+------------+------------+------------+";
+
+    printf("\n%s%s\n", rule, switches ? "----------+------------+" : "");
+    printf("|    # | Algorithm                            | Quantum | Completed | Avg Waiting  | Avg Turn.  | Avg Resp.  | p99 Turn.  | CPU Util.  |%s\n",
+           switches ? " Switches | Overhead   |" : "");
+    printf("%s%s\n", rule, switches ? "----------+------------+" : "");
+    for (int i = 0; i < count; i++)
+    {
+        char quantum[16] = "-";
+        if (configs[i].algorithm == ALG_ROUND_ROBIN)
+            snprintf(quantum, sizeof(quantum), "%d", configs[i].quantum);
+        printf("| %4d | %-36s | %7s | %9d | %12.2f | %10.2f | %10.2f | %10lld | %9.2f%% |",
+               i + 1, algorithm_names[configs[i].algorithm], quantum, results[i].processes,
+               results[i].avg_waiting, results[i].avg_turnaround, results[i].avg_response,
+               results[i].p99_turnaround, results[i].cpu_utilization);
+        if (switches)
+            printf(" %8d | %9.2f%% |", results[i].switches, results[i].switch_overhead);
+        printf("\n");
+    }
+    printf("%s%s\n", rule, switches ? "----------+------------+" : "");
+}
+
+// The sweep table as run + sweep records (one run per configuration)
+int write_sweep_results(const SweepConfig configs[], const SweepResult results[], int count, int format)
+{
+    ResultsWriter writer;
+    if (results_writer_open(&writer, stdout, format == FORMAT_JSON ? RESULTS_JSON : RESULTS_CSV) != 0)
+        return 1;
+    for (int i = 0; i < count; i++)
+    {
+        results_begin_run(&writer, algorithm_names[configs[i].algorithm], configs[i].quantum, 1,
+                          configs[i].switch_cost);
+        results_write_sweep(&writer, &results[i]);
+    }
+    results_writer_close(&writer);
+    return 0;
+}
+
+// Parallel parameter sweep over one loaded trace
+int run_sweep_mode(const Options *options)
+{
+    int *quanta = NULL;
+    int quantum_count = 0;
+    if (options->quanta != NULL)
+    {
+        quantum_count = parse_int_list(options->quanta, &quanta);
+        if (quantum_count < 0)
+        {
+            fprintf(stderr, "Error: Invalid --quanta list '%s'\n", options->quanta);
+            return 1;
+        }
+    }
+    else if (options->quantum > 0)
+    {
+        quanta = (int *)malloc(sizeof(int));
+        if (quanta == NULL)
+            return 1;
+        quanta[0] = options->quantum;
+        quantum_count = 1;
+    }
 
-// Function to display the main menu
-void display_menu()
+    int all = options->algorithm == ALGORITHM_ALL;
+    int config_count = 0;
+    SweepConfig *configs = (SweepConfig *)malloc((size_t)(quantum_count + ALG_COUNT) * sizeof(SweepConfig));
+    SweepResult *results = (SweepResult *)malloc((size_t)(quantum_count + ALG_COUNT) * sizeof(SweepResult));
+    ProcessTable processes;
+    init_process_table(&processes);
+
+    int status = 1;
+    if (configs != NULL && results != NULL && load_processes(options->input_file, &processes, options->format < FORMAT_CSV) > 0)
+    {
+        if (all || options->algorithm == ALG_ROUND_ROBIN)
+        {
+            for (int i = 0; i < quantum_count; i++)
+            {
+                configs[config_count].algorithm = ALG_ROUND_ROBIN;
+                configs[config_count].weights = options->weights;
+                configs[config_count].mlfq = options->mlfq;
+                configs[config_count].switch_cost = options->switch_cost;
+                configs[config_count].aging_selection = options->aging_selection;
+                configs[config_count++].quantum = quanta[i];
+            }
+        }
+        // The other algorithms have no quantum: one configuration each
+        for (int algorithm = ALG_AGING; algorithm <= ALG_COUNT; algorithm++)
+        {
+            if (!all && options->algorithm != algorithm)
+                continue;
+            configs[config_count].algorithm = algorithm;
+            configs[config_count].weights = options->weights;
+            configs[config_count].mlfq = options->mlfq;
+            configs[config_count].switch_cost = options->switch_cost;
+            configs[config_count].aging_selection = options->aging_selection;
+            configs[config_count++].quantum = 0;
+        }
+
+        int threads = options->threads > 0 ? options->threads : default_sweep_threads();
+        int ran;
+        if (options->work_dir != NULL)
+        {
+            SweepPlan plan;
+            int claim_timeout = options->claim_timeout >= 0 ? options->claim_timeout : SWEEP_CLAIM_TIMEOUT;
+            ran = sweep_plan_init(&plan, options->input_file, processes.items, processes.count, configs,
+                                  config_count, options->batch) == 0 &&
+                  coordinate_sweep(options->work_dir, &plan, processes.items, processes.count, results, threads,
+                                   claim_timeout, options->format < FORMAT_CSV) == 0;
+        }
+        else
+        {
+            if (options->format < FORMAT_CSV)
+                printf("Running %d configurations on %d threads\n", config_count,
+                       threads < config_count ? threads : config_count);
+            ran = run_sweep(processes.items, processes.count, configs, results, config_count, threads) == 0;
+        }
+        if (ran)
+        {
+            if (options->format >= FORMAT_CSV)
+                status = write_sweep_results(configs, results, config_count, options->format);
+            else
+            {
+                display_sweep_results(configs, results, config_count);
+                status = 0;
+            }
+        }
+    }
+
+    free_process_table(&processes);
+    free(configs);
+    free(results);
+    free(quanta);
+    return status;
+}
+
+// Work batches of a sweep another process planned (see coordinate_sweep)
+int run_sweep_worker(const Options *options)
 {
-    printf("\n");
-    printf("========================================\n");
-    printf("     CPU SCHEDULING ALGORITHMS\n");
-    printf("========================================\n");
-    printf("[1] Round Robin\n");
-    printf("    (e.g., SRTF / Preemptive Priority / Round Robin)\n");
-    printf("\n");
-    printf("[2] Modified FCFS with Aging\n");
-    printf("    (e.g., FCFS / SJF / Non-preemptive Priority)\n");
-    printf("\n");
-    printf("[3] Shortest Job First (SJF)\n");
-    printf("    (e.g., FCFS / SJF / Non-preemptive Priority)\n");
-    printf("\n");
-    printf("[4] Run All Algorithms\n");
-    printf("[5] Display Loaded Processes\n");
-    printf("[6] Reload Processes from File\n");
-    printf("[0] Exit\n");
-    printf("========================================\n");
-    printf("Enter your choice: ");
+    SweepPlan plan;
+    int found;
+    int waited = 0;
+    // Workers may be started alongside the coordinator, before its plan is written
+    while ((found = sweep_plan_read(options->sweep_worker, &plan)) == 1 && waited < SWEEP_PLAN_WAIT)
+    {
+        sweep_sleep(SWEEP_POLL_SECONDS);
+        waited += SWEEP_POLL_SECONDS;
+    }
+    if (found != 0)
+    {
+        if (found == 1)
+            fprintf(stderr, "Error: No sweep plan appeared in '%s' within %d seconds\n", options->sweep_worker,
+                    SWEEP_PLAN_WAIT);
+        return 1;
+    }
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    int status = 1;
+    int count = load_processes(plan.trace, &processes, 0);
+    if (count >= 0 && count != plan.processes)
+        fprintf(stderr, "Error: '%s' holds %d processes here, but the plan was made for %d\n", plan.trace, count,
+                plan.processes);
+    else if (count > 0 && process_table_digest(processes.items, processes.count) != plan.digest)
+        fprintf(stderr, "Error: '%s' here is not the trace the plan was made for (process digests differ)\n",
+                plan.trace);
+    else if (count > 0)
+    {
+        int threads = options->threads > 0 ? options->threads : default_sweep_threads();
+        double start = benchmark_clock();
+        int ran = sweep_work_batches(options->sweep_worker, &plan, processes.items, processes.count, threads);
+        if (ran >= 0)
+        {
+            printf("Ran %d of %d batches in %.2f s\n", ran, sweep_plan_batches(&plan), benchmark_clock() - start);
+            status = 0;
+        }
+    }
+
+    free_process_table(&processes);
+    sweep_plan_free(&plan);
+    return status;
 }
 
-// Function to display loaded processes
-void display_loaded_processes(Process processes[], int n)
+// Search for aging weights on one trace and report the best ones found
+int run_weight_search(const Options *options)
 {
-    if (n <= 0)
+    ProcessTable processes;
+    init_process_table(&processes);
+    if (load_processes(options->input_file, &processes, 1) <= 0)
     {
-        printf("\nNo processes loaded.\n");
-        return;
+        free_process_table(&processes);
+        return 1;
     }
 
-    printf("\n===== LOADED PROCESSES =====\n");
-    printf("+-----+----------+-------+----------+\n");
-    printf("| PID |  Arrival | Burst | Priority |\n");
-    printf("+-----+----------+-------+----------+\n");
+    const char *objective = options->search == SEARCH_MIN_TURNAROUND ? "turnaround" : "waiting";
+    SweepConfig start;
+    SweepResult start_result, best_result;
+    AgingWeights best;
+    start.algorithm = ALG_AGING;
+    start.quantum = 0;
+    default_aging_weights(&start.weights);
+    start.switch_cost = options->switch_cost;
+    start.aging_selection = options->aging_selection;
+
+    int threads = options->threads > 0 ? options->threads : default_sweep_threads();
+    printf("Searching aging weights minimising average %s on %d threads\n", objective, threads);
+    run_sweep(processes.items, processes.count, &start, &start_result, 1, 1);
+    int evaluated = search_aging_weights(processes.items, processes.count, &start, options->search, threads,
+                                         &best, &best_result);
+    free_process_table(&processes);
+    if (evaluated < 0)
+        return 1;
+
+    printf("Evaluated %d weight combinations\n", evaluated);
+    printf("Default weights %.3f,%.3f,%.3f: avg_waiting=%.2f avg_turnaround=%.2f\n",
+           start.weights.aging, start.weights.burst, start.weights.priority,
+           start_result.avg_waiting, start_result.avg_turnaround);
+    printf("Best weights    %.3f,%.3f,%.3f: avg_waiting=%.2f avg_turnaround=%.2f\n",
+           best.aging, best.burst, best.priority, best_result.avg_waiting, best_result.avg_turnaround);
+    printf("Use: --weights %g,%g,%g\n", best.aging, best.burst, best.priority);
+    return 0;
+}
 
+// Sum of bursts over the span of arrivals (1.0 = the CPU is kept just busy)
+double offered_load(const Process processes[], int n)
+{
+    long long work = 0;
     for (int i = 0; i < n; i++)
+        work += processes[i].burst_time;
+    SimTime span = n > 0 ? processes[n - 1].arrival_time - processes[0].arrival_time : 0;
+    return span > 0 ? (double)work / span : 0.0;
+}
+
+// Write a synthetic trace: CSV, or a binary trace if the name ends in .bin
+int run_generate(const Options *options)
+{
+    WorkloadConfig workload;
+    ProcessTable processes;
+    default_workload_config(&workload, options->generate);
+    workload.seed = options->seed;
+    init_process_table(&processes);
+
+    const char *filename = options->input_file;
+    size_t length = strlen(filename);
+    int binary = length >= 4 && strcmp(filename + length - 4, ".bin") == 0;
+    int status = 1;
+
+    // The output is the positional file name, which elsewhere is an input: never clobber one
+    FILE *existing = fopen(filename, "rb");
+    if (existing != NULL)
     {
-        printf("| %3d | %8d | %5d | %8d |\n",
-               processes[i].pid,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].priority);
+        fclose(existing);
+        fprintf(stderr, "Error: '%s' already exists; --generate will not overwrite it\n", filename);
+        return 1;
     }
 
-    printf("+-----+----------+-------+----------+\n");
-    printf("Total: %d processes\n", n);
+    if (generate_workload(&workload, &processes) > 0)
+    {
+        int written = binary ? write_processes_binary(filename, processes.items, processes.count,
+                                                      BINARY_FIELDS_REQUIRED | BINARY_FIELD_PRIORITY)
+                             : write_processes_csv(filename, processes.items, processes.count);
+        if (written == 0)
+        {
+            printf("Wrote %d synthetic processes (seed %llu, offered load %.2f) to '%s'\n", processes.count,
+                   (unsigned long long)options->seed, offered_load(processes.items, processes.count), filename);
+            status = 0;
+        }
+    }
+
+    free_process_table(&processes);
+    return status;
 }
 
-// Run a specific algorithm
-void run_algorithm(Process original[], int n, int algorithm_choice)
+// Time one engine on one trace: the best of as many runs as fit in BENCH_MIN_SECONDS.
+// *engine_bytes is the scratch memory (pools, queues, heaps) one run allocated.
+double time_engine(const Process processes[], int n, const SweepConfig *config, SweepResult *result,
+                   size_t *engine_bytes)
 {
-    if (n <= 0)
+    // Scratch memory as in a sweep worker: only the first run allocates
+    ScratchArena arena;
+    scratch_arena_init(&arena);
+    ScratchArena *previous = scratch_arena_activate(&arena);
+
+    double best = -1.0;
+    double started = benchmark_clock();
+    do
     {
-        printf("\nError: No processes loaded. Please load processes from file first.\n");
-        return;
+        scratch_arena_reset(&arena);
+        double start = benchmark_clock();
+        run_sweep_config(processes, n, config, result);
+        double elapsed = benchmark_clock() - start;
+        *engine_bytes = scratch_arena_used(&arena);
+        if (best < 0.0 || elapsed < best)
+            best = elapsed;
+    } while (benchmark_clock() - started < BENCH_MIN_SECONDS);
+
+    scratch_arena_activate(previous);
+    scratch_arena_free(&arena);
+    return best;
+}
+
+// One table section per trace, one row per engine
+int benchmark_trace(const Process processes[], int n, const Options *options)
+{
+    for (int algorithm = ALG_ROUND_ROBIN; algorithm <= ALG_COUNT; algorithm++)
+    {
+        if (options->algorithm != ALGORITHM_ALL && options->algorithm != algorithm)
+            continue;
+
+        SweepConfig config;
+        SweepResult result;
+        config.algorithm = algorithm;
+        config.quantum = options->quantum;
+        config.weights = options->weights;
+        config.mlfq = options->mlfq;
+        config.switch_cost = options->switch_cost;
+        config.aging_selection = options->aging_selection;
+
+        size_t engine_bytes = 0;
+        double seconds = time_engine(processes, n, &config, &result, &engine_bytes);
+        if (result.processes != n)
+        {
+            fprintf(stderr, "Error: %s completed %d of %d processes\n", algorithm_names[algorithm],
+                    result.processes, n);
+            return -1;
+        }
+        printf("| %10d | %-36s | %10.6f | %12.0f | %10d | %12ld |\n", n, algorithm_names[algorithm], seconds,
+               seconds > 0.0 ? n / seconds : 0.0, result.peak_jobs, (long)((engine_bytes + 1023) / 1024));
     }
+    return 0;
+}
 
-    // Create a working copy to preserve original data
-    Process working[MAX_PROCESSES];
-    copy_processes(original, working, n);
-    reset_processes(working, n);
+// Time the engines on synthetic traces of each --jobs size, or on the input file
+int run_benchmark(const Options *options)
+{
+    int *sizes = NULL;
+    int size_count = 0;
+    if (options->input_file == NULL)
+    {
+        const char *jobs = options->jobs != NULL ? options->jobs : BENCH_DEFAULT_JOBS;
+        size_count = parse_int_list(jobs, &sizes);
+        if (size_count < 0)
+        {
+            fprintf(stderr, "Error: Invalid --jobs list '%s'\n", jobs);
+            return 1;
+        }
+    }
 
-    // Gantt chart storage
-    GanttBlock gantt[MAX_PROCESSES * 10]; // Extra space for context switches
-    int gantt_size = 0;
+    const char *rule = "+------------+--------------------------------------+------------+--------------+------------+--------------+";
+    ProcessTable processes;
+    init_process_table(&processes);
+    int status = 0;
 
-    // Run the selected algorithm
-    switch (algorithm_choice)
+    printf("Benchmark: quantum %d, best of %.2f s per engine, switch cost %d\n", options->quantum,
+           BENCH_MIN_SECONDS, options->switch_cost);
+    if (options->input_file != NULL)
     {
-    case 1:
-        printf("\n===== PREEMPTIVE ALGORITHM =====\n");
-        preemptive_algorithm(working, n, gantt, &gantt_size);
-        break;
-    case 2:
-        printf("\n===== MODIFIED FCFS WITH AGING =====\n");
-        modified_FCFS_with_aging(working, n, gantt, &gantt_size);
-        break;
-    case 3:
-        printf("\n===== NON-PREEMPTIVE ALGORITHM 2 =====\n");
-        non_preemptive_algorithm_2(working, n, gantt, &gantt_size);
-        break;
-    default:
-        printf("\nInvalid algorithm choice.\n");
-        return;
+        status = load_processes(options->input_file, &processes, 1) > 0 ? 0 : 1;
+        size_count = status == 0;
     }
 
-    // Display results if algorithm was implemented
-    if (gantt_size > 0)
+    for (int i = 0; status == 0 && i < size_count; i++)
     {
-        display_gantt_chart(gantt, gantt_size);
-        display_results(working, n);
+        if (sizes != NULL)
+        {
+            WorkloadConfig workload;
+            default_workload_config(&workload, sizes[i]);
+            workload.seed = options->seed;
+            double start = benchmark_clock();
+            if (generate_workload(&workload, &processes) < 0)
+            {
+                status = 1;
+                break;
+            }
+            printf("\nGenerated %d processes in %.3f s (seed %llu, offered load %.2f)\n", processes.count,
+                   benchmark_clock() - start, (unsigned long long)options->seed,
+                   offered_load(processes.items, processes.count));
+        }
+
+        printf("%s\n", rule);
+        printf("| %10s | %-36s | %10s | %12s | %10s | %12s |\n", "Jobs", "Algorithm", "Seconds", "Jobs/sec",
+               "Peak jobs", "Engine KiB");
+        printf("%s\n", rule);
+        if (benchmark_trace(processes.items, processes.count, options) != 0)
+            status = 1;
+        printf("%s\n", rule);
+    }
+
+    free_process_table(&processes);
+    free(sizes);
+    return status;
+}
+
+// Short name of a golden case's trace for tables (the file name, or the
+// generated trace's size and seed written into label)
+static const char *golden_trace_label(const GoldenCase *golden, char *label, size_t size)
+{
+    if (golden->source[0] == '\0')
+    {
+        snprintf(label, size, "generated %d/%llu", golden->generate, (unsigned long long)golden->seed);
+        return label;
+    }
+    const char *name = strrchr(golden->source, '/');
+#ifdef _WIN32
+    const char *alt = strrchr(golden->source, '\\');
+    if (alt != NULL && (name == NULL || alt > name))
+        name = alt;
+#endif
+    return name != NULL ? name + 1 : golden->source;
+}
+
+// Load (or generate) a golden case's trace unless `loaded` already describes the same one
+static int golden_load_trace(const GoldenCase *golden, ProcessTable *processes, GoldenCase *loaded)
+{
+    if (loaded->generate == golden->generate && loaded->seed == golden->seed &&
+        strcmp(loaded->source, golden->source) == 0 && processes->count > 0)
+        return 0;
+
+    int count;
+    if (golden->source[0] != '\0')
+        count = load_processes(golden->source, processes, 0);
+    else
+    {
+        WorkloadConfig workload;
+        default_workload_config(&workload, golden->generate);
+        workload.seed = golden->seed;
+        count = generate_workload(&workload, processes);
+    }
+    if (count <= 0)
+        return -1;
+    strcpy(loaded->source, golden->source);
+    loaded->generate = golden->generate;
+    loaded->seed = golden->seed;
+    return 0;
+}
+
+#define GOLDEN_RULE "+------+--------------------------+--------------------------------------+----------+----------+------------+------------+--------+"
+
+static void golden_table_header(void)
+{
+    printf("%s\n", GOLDEN_RULE);
+    printf("| %4s | %-24s | %-36s | %8s | %8s | %10s | %10s | %-6s |\n", "#", "Trace", "Algorithm", "Seconds",
+           "Budget", "Engine KiB", "Budget", "Result");
+    printf("%s\n", GOLDEN_RULE);
+}
+
+static void golden_table_row(int index, const GoldenCase *golden, const GoldenRun *run, const char *result)
+{
+    char label[64];
+    printf("| %4d | %-24.24s | %-36s | %8.3f | %8.3f | %10ld | %10ld | %-6s |\n", index,
+           golden_trace_label(golden, label, sizeof(label)),
+           algorithm_names[golden->config.algorithm], run->seconds, golden->budget_seconds, run->engine_kb,
+           golden->budget_kb, result);
+}
+
+// Fingerprint each algorithm on the input file (or on generated --jobs traces)
+// and append the cases to a golden file. Every case runs twice and is only
+// recorded if both runs produce the same schedule.
+int run_golden_write(const Options *options)
+{
+    int *sizes = NULL;
+    int size_count = 1;
+    char source[SWEEP_PATH_MAX] = "";
+    if (options->input_file == NULL)
+    {
+        size_count = parse_int_list(options->jobs, &sizes);
+        if (size_count < 0)
+        {
+            fprintf(stderr, "Error: Invalid --jobs list '%s'\n", options->jobs);
+            return 1;
+        }
+    }
+    else if (strlen(options->input_file) >= sizeof(source))
+    {
+        fprintf(stderr, "Error: Input file name '%s' is too long\n", options->input_file);
+        return 1;
+    }
+    else
+        strcpy(source, options->input_file); // As given, so a golden file checked into a tree works in any checkout
+
+    // A new file gets the header; an existing one must already be a golden file
+    FILE *file = fopen(options->golden_write, "r");
+    int exists = file != NULL;
+    int valid = 1;
+    if (exists)
+    {
+        char line[64];
+        valid = fgets(line, sizeof(line), file) != NULL && strncmp(line, GOLDEN_MAGIC, strlen(GOLDEN_MAGIC)) == 0;
+        fclose(file);
+    }
+    file = valid ? fopen(options->golden_write, "a") : NULL;
+    if (file == NULL)
+    {
+        fprintf(stderr, valid ? "Error: Could not open '%s' for writing\n" : "Error: '%s' is not a golden file\n",
+                options->golden_write);
+        free(sizes);
+        return 1;
+    }
+    if (!exists)
+        fprintf(file, "%s %d\n", GOLDEN_MAGIC, GOLDEN_VERSION);
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    GoldenCase loaded;
+    loaded.source[0] = '\0';
+    loaded.generate = -1;
+    loaded.seed = 0;
+    int status = 0;
+    int written = 0;
+    golden_table_header();
+    for (int i = 0; status == 0 && i < size_count; i++)
+    {
+        GoldenCase golden;
+        strcpy(golden.source, source);
+        golden.generate = sizes != NULL ? sizes[i] : 0;
+        golden.seed = sizes != NULL ? options->seed : 0;
+        if (golden_load_trace(&golden, &processes, &loaded) != 0)
+        {
+            status = 1;
+            break;
+        }
+
+        for (int algorithm = ALG_ROUND_ROBIN; status == 0 && algorithm <= ALG_COUNT; algorithm++)
+        {
+            if (options->algorithm != ALGORITHM_ALL && options->algorithm != algorithm)
+                continue;
+            golden.config.algorithm = algorithm;
+            golden.config.quantum = options->quantum;
+            golden.config.weights = options->weights;
+            golden.config.mlfq = options->mlfq;
+            golden.config.switch_cost = options->switch_cost;
+            golden.config.aging_selection = options->aging_selection;
+
+            GoldenRun replay;
+            char why[128];
+            golden_run_init(&golden.run);
+            golden_run_init(&replay);
+            if (golden_run(processes.items, processes.count, &golden.config, &golden.run) != 0 ||
+                golden_run(processes.items, processes.count, &golden.config, &replay) != 0)
+                status = 1;
+            else if (golden_run_compare(&golden.run, &replay, why, sizeof(why)) != 0)
+            {
+                fprintf(stderr, "Error: %s is not deterministic: %s\n", algorithm_names[algorithm], why);
+                status = 1;
+            }
+            else
+            {
+                double slower = replay.seconds > golden.run.seconds ? replay.seconds : golden.run.seconds;
+                golden.budget_seconds = slower * GOLDEN_TIME_SLACK + GOLDEN_TIME_FLOOR;
+                golden.budget_kb = (long)(replay.engine_kb * GOLDEN_MEMORY_SLACK);
+                golden_case_write(file, &golden);
+                golden_table_row(++written, &golden, &replay, "saved");
+            }
+            golden_run_free(&golden.run);
+            golden_run_free(&replay);
+        }
+    }
+    printf("%s\n", GOLDEN_RULE);
+
+    if (fclose(file) != 0)
+        status = 1;
+    if (status == 0)
+        printf("Added %d cases to '%s'\n", written, options->golden_write);
+    free_process_table(&processes);
+    free(sizes);
+    return status;
+}
+
+// Re-run every case of a golden file and compare schedules and budgets
+// Returns 0 if every case passed, 1 otherwise
+int run_golden_check(const Options *options)
+{
+    FILE *file = fopen(options->golden_check, "r");
+    char line[64];
+    int version = 0;
+    char magic[16];
+    if (file == NULL || fgets(line, sizeof(line), file) == NULL || sscanf(line, "%15s %d", magic, &version) != 2 ||
+        strcmp(magic, GOLDEN_MAGIC) != 0 || version != GOLDEN_VERSION)
+    {
+        fprintf(stderr, file == NULL ? "Error: Could not open file '%s'\n" : "Error: '%s' is not a golden file\n",
+                options->golden_check);
+        if (file != NULL)
+            fclose(file);
+        return 1;
+    }
+
+    ProcessTable processes;
+    init_process_table(&processes);
+    GoldenCase loaded;
+    loaded.source[0] = '\0';
+    loaded.generate = -1;
+    loaded.seed = 0;
+    int cases = 0;
+    int failed = 0;
+    int read;
+    GoldenCase golden;
+    golden_table_header();
+    while ((read = golden_case_read(file, &golden)) == 1)
+    {
+        cases++;
+        GoldenRun run;
+        char why[128] = "";
+        golden_run_init(&run);
+        if (golden_load_trace(&golden, &processes, &loaded) != 0)
+            snprintf(why, sizeof(why), "trace could not be loaded");
+        else if (golden_run(processes.items, processes.count, &golden.config, &run) != 0)
+            snprintf(why, sizeof(why), "run failed");
+        else if (golden_run_compare(&golden.run, &run, why, sizeof(why)) == 0)
+        {
+            if (run.seconds > golden.budget_seconds)
+                snprintf(why, sizeof(why), "over its time budget");
+            else if (run.engine_kb > golden.budget_kb)
+                snprintf(why, sizeof(why), "over its memory budget");
+        }
+
+        golden_table_row(cases, &golden, &run, why[0] == '\0' ? "pass" : "FAIL");
+        if (why[0] != '\0')
+        {
+            printf("|      | %-108s |\n", why);
+            failed++;
+        }
+        golden_run_free(&run);
+        golden_run_free(&golden.run);
+    }
+    printf("%s\n", GOLDEN_RULE);
+    fclose(file);
+    free_process_table(&processes);
+
+    if (read < 0)
+    {
+        fprintf(stderr, "Error: '%s' is not a valid golden file (case %d)\n", options->golden_check, cases + 1);
+        return 1;
+    }
+    printf("%d of %d cases passed\n", cases - failed, cases);
+    return failed > 0 || cases == 0;
+}
+
+// Same results, Gantt chart and totals
+int same_recorded_run(const RecordedRun *a, const RecordedRun *b)
+{
+    return a->processes.count == b->processes.count && a->chart.size == b->chart.size &&
+           memcmp(a->processes.items, b->processes.items, (size_t)a->processes.count * sizeof(Process)) == 0 &&
+           memcmp(a->chart.blocks, b->chart.blocks, (size_t)a->chart.size * sizeof(GanttBlock)) == 0 &&
+           a->gantt.blocks == b->gantt.blocks && a->gantt.idle_time == b->gantt.idle_time &&
+           a->gantt.busy_time == b->gantt.busy_time && a->gantt.switch_time == b->gantt.switch_time &&
+           a->gantt.switches == b->gantt.switches;
+}
+
+// Run each algorithm on the original file, then on the edited one both
+// incrementally (resimulate) and from scratch, and compare the two
+int run_what_if(const Options *options)
+{
+    ProcessTable original;
+    ProcessTable edited;
+    init_process_table(&original);
+    init_process_table(&edited);
+    if (load_processes(options->input_file, &original, 1) <= 0 || load_processes(options->what_if, &edited, 1) <= 0)
+    {
+        free_process_table(&original);
+        free_process_table(&edited);
+        return 1;
+    }
+
+    int changed = first_changed_process(original.items, original.count, edited.items, edited.count);
+    printf("What-if: %d processes, %d after the edit, first change at process %d; snapshot every %lld\n",
+           original.count, edited.count, changed, options->snapshot_interval);
+
+    const char *rule = "+--------------------------------------+------------+-------------+------------+------------+---------+-------+";
+    printf("%s\n", rule);
+    printf("| %-36s | %10s | %11s | %10s | %10s | %7s | %5s |\n", "Algorithm", "Reused", "Resumed at",
+           "Full s", "Replay s", "Speedup", "Same");
+    printf("%s\n", rule);
+
+    int status = 0;
+    int first = options->algorithm == ALGORITHM_ALL ? 1 : options->algorithm;
+    int last = options->algorithm == ALGORITHM_ALL ? ALG_COUNT : options->algorithm;
+    for (int algorithm = first; algorithm <= last; algorithm++)
+    {
+        SweepConfig config;
+        config.algorithm = algorithm;
+        config.quantum = options->quantum;
+        config.weights = options->weights;
+        config.mlfq = options->mlfq;
+        config.switch_cost = options->switch_cost;
+        config.aging_selection = options->aging_selection;
+
+        RecordedRun base;
+        RecordedRun replay;
+        RecordedRun full;
+        recorded_run_init(&base, options->snapshot_interval);
+        recorded_run_init(&replay, options->snapshot_interval);
+        recorded_run_init(&full, options->snapshot_interval);
+
+        // Best of WHAT_IF_REPEATS, alternating which run goes first so that
+        // neither always gets the caches the other warmed up
+        int reused = record_run(original.items, original.count, &config, &base) == 0 ? 0 : -1;
+        double replay_seconds = 0.0;
+        double full_seconds = 0.0;
+        for (int repeat = 0; reused >= 0 && repeat < 2 * WHAT_IF_REPEATS; repeat++)
+        {
+            int replaying = (repeat % 2) == (repeat / 2 % 2);
+            RecordedRun *run = replaying ? &replay : &full;
+            recorded_run_free(run);
+            double start = benchmark_clock();
+            int result = replaying ? resimulate(&base, edited.items, edited.count, run)
+                                   : record_run(edited.items, edited.count, &config, run);
+            double seconds = benchmark_clock() - start;
+
+            double *best = replaying ? &replay_seconds : &full_seconds;
+            if (repeat < 2 || seconds < *best)
+                *best = seconds;
+            if (result < 0)
+                reused = -1;
+            else if (replaying)
+                reused = result;
+        }
+        if (reused < 0)
+        {
+            fprintf(stderr, "Error: %s could not be re-simulated\n", algorithm_names[algorithm]);
+            status = 1;
+        }
+        else
+        {
+            int same = same_recorded_run(&replay, &full);
+            if (!same)
+                status = 1;
+            char resumed[32];
+            if (replay.resumed_from >= 0)
+                snprintf(resumed, sizeof(resumed), "%lld", base.snapshots.items[replay.resumed_from].time);
+            else
+                snprintf(resumed, sizeof(resumed), "start");
+            printf("| %-36s | %10d | %11s | %10.6f | %10.6f | %6.1fx | %5s |\n", algorithm_names[algorithm], reused,
+                   resumed, full_seconds, replay_seconds, replay_seconds > 0.0 ? full_seconds / replay_seconds : 0.0,
+                   same ? "yes" : "NO");
+        }
+
+        recorded_run_free(&base);
+        recorded_run_free(&replay);
+        recorded_run_free(&full);
     }
+    printf("%s\n", rule);
+
+    free_process_table(&original);
+    free_process_table(&edited);
+    return status;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
-    Process processes[MAX_PROCESSES];
+    Options options;
+    int parsed = parse_arguments(argc, argv, &options);
+    if (parsed != 0)
+    {
+        if (parsed < 0)
+            fprintf(stderr, "Run '%s --help' for usage.\n", argv[0]);
+        return parsed < 0 ? 1 : 0;
+    }
+
+    if (options.convert_to != NULL)
+    {
+        int written = convert_csv_to_binary(options.input_file, options.convert_to);
+        if (written < 0)
+            return 1;
+        printf("Wrote %d processes to binary trace '%s'\n", written, options.convert_to);
+        return 0;
+    }
+
+    if (options.generate > 0)
+        return run_generate(&options);
+
+    if (options.bench)
+        return run_benchmark(&options);
+
+    if (options.what_if != NULL)
+        return run_what_if(&options);
+
+    if (options.golden_write != NULL)
+        return run_golden_write(&options);
+
+    if (options.golden_check != NULL)
+        return run_golden_check(&options);
+
+    if (options.search >= 0)
+        return run_weight_search(&options);
+
+    if (options.sweep_worker != NULL)
+        return run_sweep_worker(&options);
+
+    if (options.sweep)
+        return run_sweep_mode(&options);
+
+    if (options.stream)
+        return run_stream(&options);
+
+    if (options.algorithm != 0)
+    {
+        EngineStats stats;
+        memset(&stats, 0, sizeof(stats));
+        if (options.stats)
+            engine_stats = &stats;
+        int status = run_batch(&options);
+        engine_stats = NULL;
+        return status;
+    }
+
+    ProcessTable processes;
     int process_count = 0;
     char filename[MAX_LINE_LENGTH];
     int choice;
@@ -125,21 +2200,18 @@ int main()
     printf("========================================\n");
     printf("     CPU SCHEDULING ALGORITHMS\n");
     printf("========================================\n");
-    printf("\nEnter input filename: ");
-    scanf("%s", filename);
-
-    process_count = read_processes_from_file(filename, processes);
-
-    if (process_count > 0)
+    if (options.input_file != NULL)
     {
-        printf("\nSuccessfully loaded %d processes from '%s'\n", process_count, filename);
-        sort_by_arrival(processes, process_count); // Sort by arrival time initially
+        snprintf(filename, sizeof(filename), "%s", options.input_file);
     }
-    else if (process_count == 0)
+    else
     {
-        printf("\nWarning: File '%s' contains no valid process data.\n", filename);
+        printf("\nEnter input filename: ");
+        scanf("%s", filename);
     }
-    // If process_count < 0, error message already printed by read function
+
+    init_process_table(&processes);
+    process_count = load_processes(filename, &processes, 1);
 
     // Main menu loop
     do
@@ -152,37 +2224,31 @@ int main()
         case 1:
         case 2:
         case 3:
-            run_algorithm(processes, process_count, choice);
+        case MENU_SRTF:
+        case MENU_PRIORITY:
+        case MENU_MLFQ:
+            run_algorithm(processes.items, process_count, menu_algorithm(choice), &options, FORMAT_TEXT, NULL, NULL);
             break;
 
-        case 4:
+        case MENU_RUN_ALL:
             // Run all algorithms
             printf("\n============ RUNNING ALL ALGORITHMS ============\n");
-            for (int i = 1; i <= 3; i++)
+            for (int i = 1; i <= ALG_COUNT; i++)
             {
-                run_algorithm(processes, process_count, i);
+                run_algorithm(processes.items, process_count, i, &options, FORMAT_TEXT, NULL, NULL);
                 printf("\n------------------------------------------------\n");
             }
             break;
 
-        case 5:
-            display_loaded_processes(processes, process_count);
+        case MENU_DISPLAY:
+            display_loaded_processes(processes.items, process_count);
             break;
 
-        case 6:
+        case MENU_RELOAD:
             // Reload from file
             printf("\nEnter input filename: ");
             scanf("%s", filename);
-            process_count = read_processes_from_file(filename, processes);
-            if (process_count > 0)
-            {
-                printf("\nSuccessfully loaded %d processes from '%s'\n", process_count, filename);
-                sort_by_arrival(processes, process_count);
-            }
-            else if (process_count == 0)
-            {
-                printf("\nWarning: File '%s' contains no valid process data.\n", filename);
-            }
+            process_count = load_processes(filename, &processes, 1);
             break;
 
         case 0:
@@ -195,5 +2261,6 @@ int main()
 
     } while (choice != 0);
 
+    free_process_table(&processes);
     return 0;
 }
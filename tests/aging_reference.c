@@ -0,0 +1,163 @@
+// Differential check for aging scan selection (built and run by run_tests.sh).
+// Runs modified_FCFS_with_aging with AGING_SELECT_SCAN on each trace given on
+// the command line and on generated traces, and compares every completion
+// time with the original selection loop below, for several weight sets.
+//
+//   aging_reference TRACE...
+//
+// Prints one line per mismatch and exits non-zero if there was any.
+
+#include "../functions.h"
+
+// The original aging loop: score every arrived job at each pick, keep a
+// running best in table order, and take scores within 0.001 as a tie won by
+// the earlier arrival. Fills completion_time; processes must be in arrival order.
+static void reference_aging(Process processes[], int n, const AgingWeights *weights)
+{
+    SimTime current_time = 0;
+    int completed = 0;
+
+    while (completed < n)
+    {
+        int best_idx = -1;
+        double best_score = -999999.0;
+
+        for (int i = 0; i < n; i++)
+        {
+            if (!processes[i].completed && processes[i].arrival_time <= current_time)
+            {
+                SimTime wait_time = current_time - processes[i].arrival_time;
+                double score = (wait_time * weights->aging) - (processes[i].burst_time * weights->burst) -
+                               (processes[i].priority * weights->priority);
+
+                if (best_idx == -1 || score > best_score + 0.001)
+                {
+                    best_score = score;
+                    best_idx = i;
+                }
+                else if (fabs(score - best_score) <= 0.001)
+                {
+                    if (processes[i].arrival_time < processes[best_idx].arrival_time)
+                    {
+                        best_score = score;
+                        best_idx = i;
+                    }
+                }
+            }
+        }
+
+        if (best_idx == -1)
+        {
+            // CPU idle until the next arrival
+            for (int i = 0; i < n; i++)
+            {
+                if (!processes[i].completed)
+                {
+                    current_time = processes[i].arrival_time;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            current_time += processes[best_idx].burst_time;
+            processes[best_idx].completion_time = current_time;
+            processes[best_idx].completed = 1;
+            completed++;
+        }
+    }
+}
+
+// Compare scan selection with the reference on one trace; returns the number of mismatches
+static int check_trace(const char *name, Process processes[], int n)
+{
+    static const AgingWeights weight_sets[] = {
+        {2.0, 0.5, 3.0}, {0.7, 0.1, 0.0003}, {1.0, 0.0004, 0.0}, {1.3, 0.37, 2.9}, {0.001, 1.0, 0.0}, {0.0, 0.0, 1.0},
+    };
+    int mismatches = 0;
+
+    Process *scan = (Process *)malloc((size_t)n * sizeof(Process));
+    Process *reference = (Process *)malloc((size_t)n * sizeof(Process));
+    if (scan == NULL || reference == NULL)
+    {
+        printf("FAIL: out of memory for %s\n", name);
+        free(scan);
+        free(reference);
+        return 1;
+    }
+
+    for (size_t w = 0; w < sizeof(weight_sets) / sizeof(weight_sets[0]); w++)
+    {
+        const AgingWeights *weights = &weight_sets[w];
+        copy_processes(processes, scan, n);
+        reset_processes(scan, n);
+        sort_by_arrival(scan, n);
+        copy_processes(scan, reference, n);
+
+        GanttSink gantt;
+        gantt_sink_init_summary(&gantt);
+        modified_FCFS_with_aging(scan, n, weights, AGING_SELECT_SCAN, &gantt);
+        reference_aging(reference, n, weights);
+
+        for (int i = 0; i < n; i++)
+        {
+            if (scan[i].completion_time != reference[i].completion_time)
+            {
+                printf("FAIL: %s with -w %g,%g,%g: P%d completes at %lld, the original loop says %lld\n", name,
+                       weights->aging, weights->burst, weights->priority, scan[i].pid,
+                       (long long)scan[i].completion_time, (long long)reference[i].completion_time);
+                mismatches++;
+                break;
+            }
+        }
+    }
+
+    free(scan);
+    free(reference);
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int mismatches = 0;
+    trace_level = TRACE_NONE;
+
+    for (int i = 1; i < argc; i++)
+    {
+        ProcessTable table;
+        init_process_table(&table);
+        if (read_processes_from_file(argv[i], &table) < 0)
+        {
+            printf("FAIL: cannot read %s\n", argv[i]);
+            mismatches++;
+            continue;
+        }
+        mismatches += check_trace(argv[i], table.items, table.count);
+        free_process_table(&table);
+    }
+
+    // Generated traces: few priorities and short bursts make close scores common
+    for (uint64_t seed = 1; seed <= 4; seed++)
+    {
+        WorkloadConfig config;
+        default_workload_config(&config, 2000);
+        config.seed = seed;
+        config.priorities = 3;
+        config.burst_max = 20;
+
+        ProcessTable table;
+        init_process_table(&table);
+        if (generate_workload(&config, &table) < 0)
+        {
+            printf("FAIL: cannot generate trace %llu\n", (unsigned long long)seed);
+            mismatches++;
+            continue;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "generated seed %llu", (unsigned long long)seed);
+        mismatches += check_trace(name, table.items, table.count);
+        free_process_table(&table);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#!/bin/sh
+# Regression checks for the scheduler. Builds main.c into a temporary
+# directory and runs every check below; nothing is written into the tree.
+#
+#   tests/run_tests.sh                      # from any directory
+#   CFLAGS='-O2 -march=native' tests/run_tests.sh   # also exercise the AVX2/NEON kernels
+#
+# Exits non-zero if the build or any check fails.
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=$(mktemp -d "${TMPDIR:-/tmp}/scheduler-tests.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT INT TERM
+
+cc=${CC:-gcc}
+cflags=${CFLAGS:--std=c99 -O2}
+# shellcheck disable=SC2086
+if ! $cc $cflags -o "$work/scheduler" "$root/main.c" -lm -lpthread; then
+    echo "FAIL: build"
+    exit 1
+fi
+scheduler="$work/scheduler"
+failures=0
+
+fail()
+{
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# --- Golden schedules: every engine still produces the committed ones ---
+# tests/golden/schedules.txt holds output/processes.txt, output/processes_with_idle.txt
+# and a generated 20000-process trace (seed 7), each under all six algorithms at the
+# default quantum. Trace paths in it are relative to the repository root. After an
+# intended schedule change, delete the file and rebuild it from the root with
+#   ./scheduler --golden-write tests/golden/schedules.txt output/processes.txt
+#   ./scheduler --golden-write tests/golden/schedules.txt output/processes_with_idle.txt
+#   ./scheduler --golden-write tests/golden/schedules.txt --jobs 20000 --seed 7
+(cd "$root" && "$scheduler" --golden-check tests/golden/schedules.txt) > "$work/golden.out" 2>&1 || {
+    cat "$work/golden.out"
+    fail "golden schedules"
+}
+
+# --- Aging: scan selection is the original selection loop ---
+# tests/aging_reference.c runs the scan on these traces and on generated ones and
+# compares every completion time with a copy of the original loop, for several weights.
+# shellcheck disable=SC2086
+if $cc $cflags -o "$work/aging_reference" "$root/tests/aging_reference.c" -lm -lpthread; then
+    "$work/aging_reference" "$root/output/processes.txt" "$root/output/processes_with_idle.txt" \
+        "$root/tests/data/aging_ties.csv" "$root/tests/data/aging_grid.csv" || fail "aging scan against the original loop"
+else
+    fail "build tests/aging_reference.c"
+fi
+
+# --- Aging: heap and scan selection give the same schedule ---
+# With weights that are multiples of 0.5 every score is a multiple of 0.5, the
+# heap's rounded key is exact and it must pick what the scan picks, so the full
+# text output (dispatch trace, chart, results) must match.
+"$scheduler" --generate 5000 --seed 7 "$work/generated.csv" > /dev/null || fail "generate trace"
+for trace in "$root/output/processes.txt" "$root/output/processes_with_idle.txt" \
+    "$root/tests/data/aging_ties.csv" "$work/generated.csv"; do
+    for weights in 2.0,0.5,3.0 1.5,0.5,2.0 4,1,0.5 0,0,1; do
+        "$scheduler" -a aging -w "$weights" --aging-select heap "$trace" > "$work/heap.out" 2>&1
+        "$scheduler" -a aging -w "$weights" --aging-select scan "$trace" > "$work/scan.out" 2>&1
+        cmp -s "$work/heap.out" "$work/scan.out" ||
+            fail "aging heap and scan differ on $(basename "$trace") with -w $weights"
+    done
+done
+
+# --- Zero bursts: such jobs complete at their arrival under every algorithm ---
+# Batch, streamed and sweep runs must agree on the averages, and no metric may
+# go negative (a job left with completion time 0 would pull them below zero).
+for algorithm in rr aging sjf srtf priority mlfq; do
+    "$scheduler" -a "$algorithm" -q 2 -f csv "$root/tests/data/zero_burst.csv" > "$work/zero.csv" 2>&1 ||
+        fail "$algorithm on zero_burst.csv"
+    awk -F, '$1 == "process" && $4 + 0 > $7 + 0 { bad = 1 } END { exit bad }' "$work/zero.csv" ||
+        fail "$algorithm completes a job before it arrives on zero_burst.csv"
+    for mode in "" -s; do
+        "$scheduler" -a "$algorithm" -q 2 $mode -f summary "$root/tests/data/zero_burst.csv" 2>&1 |
+            tail -n 1 > "$work/zero.out"
+        grep -q '=-' "$work/zero.out" && fail "$algorithm ${mode:-batch} reports a negative metric on zero_burst.csv"
+        grep -q 'processes=5 ' "$work/zero.out" || fail "$algorithm ${mode:-batch} does not complete all of zero_burst.csv"
+        sed -n 's/.*\(avg_waiting=[^ ]*\) \(avg_turnaround=[^ ]*\).*/\1 \2/p' "$work/zero.out" >> "$work/zero.avg"
+    done
+    "$scheduler" --sweep -a "$algorithm" -q 2 -f csv "$root/tests/data/zero_burst.csv" 2>&1 |
+        awk -F, '$1 == "sweep" { printf "avg_waiting=%.2f avg_turnaround=%.2f\n", $4, $5 }' >> "$work/zero.avg"
+    [ "$(sort -u "$work/zero.avg" | wc -l)" -eq 1 ] || fail "$algorithm batch, stream and sweep averages differ on zero_burst.csv"
+    rm -f "$work/zero.avg"
+done
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures check(s) failed"
+    exit 1
+fi
+echo "All checks passed"